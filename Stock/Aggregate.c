@@ -0,0 +1,189 @@
+/* 
+ * File:   Aggregate.c
+ * Author: Paulo Jorge
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "Aggregate.h"
+#include "ComponentType.h"
+
+/**
+ * Method to get the amount a single unit of a stock item adds to a 
+ * aggregate measure.
+ * 
+ * @param  Pointer to stock item.
+ * @param  Measure being summed.
+ * @return Value of one unit of stock item.
+ */
+static long long aggregate_unitValue(const StockItem *item, 
+        AggregateMeasure measure) {
+    switch (measure) {
+        case AGGREGATE_QUANTITY:
+            return 1;
+        case AGGREGATE_STOCK_VALUE:
+            return stockItem_getPennies(item);
+        case AGGREGATE_ATTRIBUTE:
+            return stockItem_getAttribute(item).value;
+    }
+    return 0;
+}
+
+/**
+ * Method to allocate memory for a new empty aggregate set. Or generates 
+ * error message if memory allocation fails and terminates program.
+ * 
+ * @return Pointer to newly created aggregate set.
+ */
+AggregateSet* aggregateSet_new() {
+    // Allocate aggregate set to memory
+    AggregateSet *set = (AggregateSet*)malloc(sizeof(AggregateSet));
+    // Null check memory allocation
+    if (!set) {
+        fprintf(stderr, "Error: Unable to allocate memory in "
+                "aggregateSet_new().\n");
+        exit(EXIT_FAILURE);
+    }
+    
+    set->count = 0;
+    
+    return set;
+}
+
+/**
+ * Method to register a new aggregate in a set. Its total starts at 0, 
+ * stock items already covered by the set must be added with 
+ * aggregateSet_include(). Or generates error message if the set is full 
+ * and terminates program.
+ * 
+ * @param  Pointer to aggregate set.
+ * @param  Measure to be summed.
+ * @param  Predicate deciding which stock items are summed.
+ * @param  Pointer to context passed to predicate, must outlive the set.
+ * @return Integer ID of aggregate within set.
+ */
+int aggregateSet_register(AggregateSet *set, AggregateMeasure measure, 
+        AggregatePredicate predicate, const void *context) {
+    // Output error and exit if aggregate would not fit the item mask
+    if (set->count == AGGREGATE_MAX) {
+        fprintf(stderr, "Error: Too many aggregates registered in "
+                "aggregateSet_register().\n");
+        exit(EXIT_FAILURE);
+    }
+    
+    Aggregate *aggregate = &set->aggregates[set->count];
+    aggregate->measure   = measure;
+    aggregate->predicate = predicate;
+    aggregate->context   = context;
+    atomic_init(&aggregate->total, 0);
+    
+    return set->count++;
+}
+
+/**
+ * Method to add a stock item to the aggregates of a set, evaluating each
+ * predicate once. Aggregates from the given ID onwards are evaluated, so
+ * a newly registered aggregate can be filled without recounting others.
+ * 
+ * @param Pointer to aggregate set.
+ * @param Pointer to stock item to be added.
+ * @param Integer ID of first aggregate to evaluate.
+ */
+void aggregateSet_include(AggregateSet *set, StockItem *item, int from) {
+    // Start a fresh mask when item joins the set
+    if (from == 0)
+        item->aggregateMask = 0;
+    item->aggregates = set;
+    
+    for (int i = from; i < set->count; i++) {
+        Aggregate *aggregate = &set->aggregates[i];
+        
+        // Remember membership so sales only touch matching aggregates
+        if (aggregate->predicate(item, aggregate->context)) {
+            item->aggregateMask |= 1u << i;
+            atomic_fetch_add_explicit(&aggregate->total, 
+                    (long long)stockItem_getQuantity(item) 
+                    * aggregate_unitValue(item, aggregate->measure), 
+                    memory_order_relaxed);
+        }
+    }
+}
+
+/**
+ * Method to remove a stock item from all aggregates of the set it belongs
+ * to, if any.
+ * 
+ * @param Pointer to stock item to be removed.
+ */
+void aggregateSet_exclude(StockItem *item) {
+    // Subtract all stock of item from its aggregates
+    aggregateSet_applyDelta(item, -stockItem_getQuantity(item));
+    
+    item->aggregates    = NULL;
+    item->aggregateMask = 0;
+}
+
+/**
+ * Method to apply a change in quantity of a stock item to all aggregates 
+ * of the set it belongs to, if any.
+ * 
+ * @param Pointer to stock item whose quantity has changed.
+ * @param Integer change in quantity.
+ */
+void aggregateSet_applyDelta(const StockItem *item, int quantityDelta) {
+    AggregateSet *set = item->aggregates;
+    
+    // Visit only aggregates the item belongs to
+    for (unsigned int mask = item->aggregateMask; mask != 0; 
+            mask &= mask - 1) {
+        Aggregate *aggregate = &set->aggregates[__builtin_ctz(mask)];
+        atomic_fetch_add_explicit(&aggregate->total, (long long)quantityDelta 
+                * aggregate_unitValue(item, aggregate->measure), 
+                memory_order_relaxed);
+    }
+}
+
+/**
+ * Get method to get the current total of a aggregate.
+ * 
+ * @param  Pointer to aggregate set.
+ * @param  Integer ID of aggregate.
+ * @return Current total of aggregate.
+ */
+long long aggregateSet_get(const AggregateSet *set, int aggregate) {
+    return atomic_load_explicit(&set->aggregates[aggregate].total, 
+            memory_order_relaxed);
+}
+
+/**
+ * Predicate matching stock items against a AggregateFilter context.
+ * 
+ * @param  Pointer to stock item to be checked.
+ * @param  Pointer to AggregateFilter.
+ * @return 1 if stock item matches filter or 0 if not.
+ */
+int aggregate_filter(const StockItem *item, const void *context) {
+    const AggregateFilter *filter = (const AggregateFilter*)context;
+    Attribute attribute = stockItem_getAttribute(item);
+    
+    if ((filter->type != COMPONENT_TYPE_NONE) 
+            && (filter->type != stockItem_getTypeCode(item)))
+        return 0;
+    if ((filter->kind != ATTRIBUTE_NONE) 
+            && ((attribute.kind != filter->kind) 
+            || (attribute.value < filter->minValue) 
+            || (attribute.value > filter->maxValue)))
+        return 0;
+    
+    return 1;
+}
+
+/**
+ * Method to free aggregate set from memory.
+ * 
+ * @param Pointer to aggregate set to which will be freed from memory.
+ */
+void aggregateSet_free(AggregateSet *set) {
+    free(set);
+}
@@ -0,0 +1,159 @@
+/* 
+ * File:   Aggregate.h
+ * Author: Paulo Jorge
+ */
+
+#ifndef AGGREGATE_H
+#define AGGREGATE_H
+
+#include <stdatomic.h>
+
+#include "StockItem.h"
+#include "Attribute.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Maximum number of aggregates a set can hold, one per bit of the stock
+ * item aggregate mask.
+ */
+#define AGGREGATE_MAX 32
+
+/**
+ * Measures an aggregate can sum over its matching stock items.
+ */
+typedef enum AggregateMeasureEnum {
+    // Sum of quantity in stock
+    AGGREGATE_QUANTITY,
+    // Sum of quantity x price in pennies
+    AGGREGATE_STOCK_VALUE,
+    // Sum of quantity x attribute value, such as total resistance
+    AGGREGATE_ATTRIBUTE
+}
+AggregateMeasure;
+
+/**
+ * Predicate deciding if a stock item belongs to a aggregate.
+ */
+typedef int (*AggregatePredicate)(const StockItem *item, const void *context);
+
+/**
+ * Filter used as context for aggregate_filter(), matching stock items on
+ * type and attribute.
+ */
+typedef struct AggregateFilterStruct {
+    // Type code to match, or COMPONENT_TYPE_NONE to match any type
+    int type;
+    // Attribute kind to match, or ATTRIBUTE_NONE to match any attribute
+    AttributeKind kind;
+    // Inclusive attribute value range, used when kind is set
+    long long minValue, maxValue;
+}
+AggregateFilter;
+
+/**
+ * Structure defining a single materialised aggregate.
+ */
+typedef struct AggregateStruct {
+    AggregateMeasure measure;
+    AggregatePredicate predicate;
+    const void *context;
+    // Atomic so sales made from several threads can update it
+    _Atomic long long total;
+}
+Aggregate;
+
+/**
+ * Set of aggregates kept up to date as the stock items they cover are 
+ * added, removed and sold.
+ */
+typedef struct AggregateSetStruct {
+    Aggregate aggregates[AGGREGATE_MAX];
+    int count;
+}
+AggregateSet;
+
+/**
+ * Method to allocate memory for a new empty aggregate set. Or generates 
+ * error message if memory allocation fails and terminates program.
+ * 
+ * @return Pointer to newly created aggregate set.
+ */
+AggregateSet* aggregateSet_new();
+
+/**
+ * Method to register a new aggregate in a set. Its total starts at 0, 
+ * stock items already covered by the set must be added with 
+ * aggregateSet_include(). Or generates error message if the set is full 
+ * and terminates program.
+ * 
+ * @param  Pointer to aggregate set.
+ * @param  Measure to be summed.
+ * @param  Predicate deciding which stock items are summed.
+ * @param  Pointer to context passed to predicate, must outlive the set.
+ * @return Integer ID of aggregate within set.
+ */
+int aggregateSet_register(AggregateSet *set, AggregateMeasure measure, 
+        AggregatePredicate predicate, const void *context);
+
+/**
+ * Method to add a stock item to the aggregates of a set, evaluating each
+ * predicate once. Aggregates from the given ID onwards are evaluated, so
+ * a newly registered aggregate can be filled without recounting others.
+ * 
+ * @param Pointer to aggregate set.
+ * @param Pointer to stock item to be added.
+ * @param Integer ID of first aggregate to evaluate.
+ */
+void aggregateSet_include(AggregateSet *set, StockItem *item, int from);
+
+/**
+ * Method to remove a stock item from all aggregates of the set it belongs
+ * to, if any.
+ * 
+ * @param Pointer to stock item to be removed.
+ */
+void aggregateSet_exclude(StockItem *item);
+
+/**
+ * Method to apply a change in quantity of a stock item to all aggregates 
+ * of the set it belongs to, if any.
+ * 
+ * @param Pointer to stock item whose quantity has changed.
+ * @param Integer change in quantity.
+ */
+void aggregateSet_applyDelta(const StockItem *item, int quantityDelta);
+
+/**
+ * Get method to get the current total of a aggregate.
+ * 
+ * @param  Pointer to aggregate set.
+ * @param  Integer ID of aggregate.
+ * @return Current total of aggregate.
+ */
+long long aggregateSet_get(const AggregateSet *set, int aggregate);
+
+/**
+ * Predicate matching stock items against a AggregateFilter context.
+ * 
+ * @param  Pointer to stock item to be checked.
+ * @param  Pointer to AggregateFilter.
+ * @return 1 if stock item matches filter or 0 if not.
+ */
+int aggregate_filter(const StockItem *item, const void *context);
+
+/**
+ * Method to free aggregate set from memory.
+ * 
+ * @param Pointer to aggregate set to which will be freed from memory.
+ */
+void aggregateSet_free(AggregateSet *set);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AGGREGATE_H */
+
@@ -0,0 +1,86 @@
+/* 
+ * File:   Arena.c
+ * Author: Paulo Jorge
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "Arena.h"
+
+/**
+ * Method to initialise a empty arena.
+ * 
+ * @param Pointer to arena.
+ */
+void arena_init(Arena *arena) {
+    arena->blocks     = NULL;
+    arena->allocated  = 0;
+    arena->blockCount = 0;
+}
+
+/**
+ * Method to allocate memory from a arena, aligned for any type. Or 
+ * generates error message if memory allocation fails and terminates 
+ * program.
+ * 
+ * @param  Pointer to arena.
+ * @param  Size of memory needed in bytes.
+ * @return Pointer to allocated memory.
+ */
+void *arena_alloc(Arena *arena, size_t size) {
+    // Round up so next allocation stays aligned
+    size_t align = _Alignof(max_align_t);
+    size = (size + align - 1) / align * align;
+    
+    // Start a new block when current block is full
+    ArenaBlock *block = arena->blocks;
+    if (!block || (block->size - block->used < size)) {
+        size_t blockSize = (size > ARENA_BLOCK_SIZE) ? size 
+                : ARENA_BLOCK_SIZE;
+        ArenaBlock *added = (ArenaBlock*)malloc(sizeof(ArenaBlock) 
+                + blockSize);
+        // Null check memory allocation
+        if (!added) {
+            fprintf(stderr, "Error: Unable to allocate memory in "
+                    "arena_alloc().\n");
+            exit(EXIT_FAILURE);
+        }
+        added->size = blockSize;
+        added->used = 0;
+        arena->blockCount++;
+        
+        // Keep current block first if a large allocation leaves it more 
+        // room than the new block
+        if (block && (size > ARENA_BLOCK_SIZE)) {
+            added->next = block->next;
+            block->next = added;
+        } else {
+            added->next   = block;
+            arena->blocks = added;
+        }
+        block = added;
+    }
+    
+    void *memory = (char*)block->data + block->used;
+    block->used      += size;
+    arena->allocated += size;
+    
+    return memory;
+}
+
+/**
+ * Method to free every block of a arena, leaving it empty.
+ * 
+ * @param Pointer to arena.
+ */
+void arena_free(Arena *arena) {
+    ArenaBlock *block = arena->blocks;
+    while (block) {
+        ArenaBlock *next = block->next;
+        free(block);
+        block = next;
+    }
+    
+    arena_init(arena);
+}
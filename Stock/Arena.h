@@ -0,0 +1,73 @@
+/* 
+ * File:   Arena.h
+ * Author: Paulo Jorge
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Size of each block of a arena, allocations larger than this get a block
+ * of their own.
+ */
+#define ARENA_BLOCK_SIZE 65536
+
+/**
+ * Block of a arena, with memory handed out from the start of its data.
+ */
+typedef struct ArenaBlockStruct {
+    struct ArenaBlockStruct *next;
+    size_t size, used;
+    max_align_t data[];
+}
+ArenaBlock;
+
+/**
+ * Bump allocator handing out memory that is never freed on its own, only
+ * all at once when the arena is freed. Used for data created together and 
+ * kept for as long as its owner, such as stock items read from a file.
+ */
+typedef struct ArenaStruct {
+    ArenaBlock *blocks;
+    // Total bytes handed out and number of blocks allocated
+    size_t allocated;
+    int blockCount;
+}
+Arena;
+
+/**
+ * Method to initialise a empty arena.
+ * 
+ * @param Pointer to arena.
+ */
+void arena_init(Arena *arena);
+
+/**
+ * Method to allocate memory from a arena, aligned for any type. Or 
+ * generates error message if memory allocation fails and terminates 
+ * program.
+ * 
+ * @param  Pointer to arena.
+ * @param  Size of memory needed in bytes.
+ * @return Pointer to allocated memory.
+ */
+void *arena_alloc(Arena *arena, size_t size);
+
+/**
+ * Method to free every block of a arena, leaving it empty.
+ * 
+ * @param Pointer to arena.
+ */
+void arena_free(Arena *arena);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ARENA_H */
@@ -0,0 +1,154 @@
+/* 
+ * File:   Attribute.c
+ * Author: Paulo Jorge
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "Attribute.h"
+
+/**
+ * Method to parse a number written with a letter in place of its decimal
+ * point, such as "4K7", returning its digits, scale and letter.
+ * 
+ * @param  Char code to parse.
+ * @param  Pointer to where all digits as one integer will be stored.
+ * @param  Pointer to where 10 to the power of decimal places is stored.
+ * @param  Pointer to where letter will be stored, or '\0' if none.
+ * @return Pointer to first char after the number, or null if invalid.
+ */
+static const char *attribute_parseNumber(const char *code, long long *digits,
+        long long *scale, char *letter) {
+    *digits = 0;
+    *scale  = 1;
+    *letter = '\0';
+    
+    // Must start with a digit
+    if (!isdigit((unsigned char)*code))
+        return NULL;
+    
+    for (; *code != '\0'; code++) {
+        if (isdigit((unsigned char)*code)) {
+            *digits = *digits * 10 + (*code - '0');
+            // Digits after the letter are decimal places
+            if (*letter)
+                *scale *= 10;
+        } else if (!*letter && isalpha((unsigned char)*code))
+            *letter = *code;
+        else
+            break;
+    }
+    
+    return code;
+}
+
+/**
+ * Method to parse a BS 1852 resistance code, such as "4K7" or "10R", where
+ * the letter gives the multiplier and marks the decimal point.
+ * 
+ * @param  Char resistance code.
+ * @param  Pointer to where resistance in milliohms will be stored.
+ * @return 1 if code was parsed or 0 if not.
+ */
+int attribute_parseResistance(const char *code, long long *milliohms) {
+    long long digits, scale, multiplier;
+    char letter;
+    
+    code = attribute_parseNumber(code, &digits, &scale, &letter);
+    if (!code || (*code != '\0'))
+        return 0;
+    
+    // Determine multiplier from letter
+    if ((letter == 'R') || (letter == '\0'))
+        multiplier = 1000;
+    else if (letter == 'K')
+        multiplier = 1000000;
+    else if (letter == 'M')
+        multiplier = 1000000000;
+    else
+        return 0;
+    
+    *milliohms = digits * multiplier / scale;
+    return 1;
+}
+
+/**
+ * Method to parse a capacitance, such as "22pF", "100nF", "4u7" or 
+ * "1000pf", where the letter gives the unit and marks the decimal point.
+ * 
+ * @param  Char capacitance.
+ * @param  Pointer to where capacitance in picofarads will be stored.
+ * @return 1 if capacitance was parsed or 0 if not.
+ */
+int attribute_parseCapacitance(const char *code, long long *picofarads) {
+    long long digits, scale, multiplier;
+    char letter;
+    
+    code = attribute_parseNumber(code, &digits, &scale, &letter);
+    if (!code)
+        return 0;
+    
+    // Determine multiplier from unit letter
+    if (letter == 'p')
+        multiplier = 1;
+    else if (letter == 'n')
+        multiplier = 1000;
+    else if (letter == 'u')
+        multiplier = 1000000;
+    else
+        return 0;
+    
+    // Allow trailing farad symbol in either case
+    if ((*code == 'F') || (*code == 'f'))
+        code++;
+    if (*code != '\0')
+        return 0;
+    
+    *picofarads = digits * multiplier / scale;
+    return 1;
+}
+
+/**
+ * Method to parse the description of a stock item into a typed attribute,
+ * based on the stock item type. Resistors use BS 1852 coding such as "4K7",
+ * capacitors values such as "22pF" or "100nF" and transistors "NPN", "PNP"
+ * or "FET".
+ * 
+ * @param  Char type of stock item.
+ * @param  Char description of stock item.
+ * @return Parsed attribute, of kind ATTRIBUTE_NONE if type has no 
+ *         attribute or description could not be parsed.
+ */
+Attribute attribute_parse(const char *type, const char *desc) {
+    Attribute attribute = { 0, ATTRIBUTE_NONE };
+    
+    if (!desc)
+        return attribute;
+    
+    if (strcmp(type, "resistor") == 0) {
+        if (attribute_parseResistance(desc, &attribute.value))
+            attribute.kind = ATTRIBUTE_RESISTANCE;
+    } else if (strcmp(type, "capacitor") == 0) {
+        if (attribute_parseCapacitance(desc, &attribute.value))
+            attribute.kind = ATTRIBUTE_CAPACITANCE;
+    } else if (strcmp(type, "transistor") == 0) {
+        attribute.kind = ATTRIBUTE_POLARITY;
+        if (strcmp(desc, "NPN") == 0)
+            attribute.value = ATTRIBUTE_POLARITY_NPN;
+        else if (strcmp(desc, "PNP") == 0)
+            attribute.value = ATTRIBUTE_POLARITY_PNP;
+        else if (strcmp(desc, "FET") == 0)
+            attribute.value = ATTRIBUTE_POLARITY_FET;
+        else
+            attribute.kind = ATTRIBUTE_NONE;
+    }
+    
+    // Reset value if description could not be parsed
+    if (attribute.kind == ATTRIBUTE_NONE)
+        attribute.value = 0;
+    
+    return attribute;
+}
@@ -0,0 +1,82 @@
+/* 
+ * File:   Attribute.h
+ * Author: Paulo Jorge
+ */
+
+#ifndef ATTRIBUTE_H
+#define ATTRIBUTE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Kinds of attribute a stock item description can be parsed into.
+ */
+typedef enum AttributeKindEnum {
+    ATTRIBUTE_NONE,
+    // Resistance in milliohms
+    ATTRIBUTE_RESISTANCE,
+    // Capacitance in picofarads
+    ATTRIBUTE_CAPACITANCE,
+    // Transistor polarity, one of the ATTRIBUTE_POLARITY values
+    ATTRIBUTE_POLARITY
+}
+AttributeKind;
+
+/**
+ * Transistor polarity attribute values.
+ */
+#define ATTRIBUTE_POLARITY_NPN 1
+#define ATTRIBUTE_POLARITY_PNP 2
+#define ATTRIBUTE_POLARITY_FET 3
+
+/**
+ * Structure defining a typed numeric attribute parsed from a stock item
+ * description.
+ */
+typedef struct AttributeStruct {
+    long long value;
+    AttributeKind kind;
+}
+Attribute;
+
+/**
+ * Method to parse the description of a stock item into a typed attribute,
+ * based on the stock item type. Resistors use BS 1852 coding such as "4K7",
+ * capacitors values such as "22pF" or "100nF" and transistors "NPN", "PNP"
+ * or "FET".
+ * 
+ * @param  Char type of stock item.
+ * @param  Char description of stock item.
+ * @return Parsed attribute, of kind ATTRIBUTE_NONE if type has no 
+ *         attribute or description could not be parsed.
+ */
+Attribute attribute_parse(const char *type, const char *desc);
+
+/**
+ * Method to parse a BS 1852 resistance code, such as "4K7" or "10R", where
+ * the letter gives the multiplier and marks the decimal point.
+ * 
+ * @param  Char resistance code.
+ * @param  Pointer to where resistance in milliohms will be stored.
+ * @return 1 if code was parsed or 0 if not.
+ */
+int attribute_parseResistance(const char *code, long long *milliohms);
+
+/**
+ * Method to parse a capacitance, such as "22pF", "100nF", "4u7" or 
+ * "1000pf", where the letter gives the unit and marks the decimal point.
+ * 
+ * @param  Char capacitance.
+ * @param  Pointer to where capacitance in picofarads will be stored.
+ * @return 1 if capacitance was parsed or 0 if not.
+ */
+int attribute_parseCapacitance(const char *code, long long *picofarads);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ATTRIBUTE_H */
+
@@ -0,0 +1,1733 @@
+/* 
+ * File:   Benchmark.c
+ * Author: Paulo Jorge
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <fcntl.h>
+
+#include "Benchmark.h"
+#include "StockItem.h"
+#include "Inventory.h"
+#include "Sales.h"
+#include "Date.h"
+#include "Loader.h"
+#include "SalesIndex.h"
+#include "SalesRollup.h"
+#include "TopSellers.h"
+#include "ComponentType.h"
+#include "Aggregate.h"
+#include "ShardedInventory.h"
+#include "InventoryView.h"
+#include "SaleQueue.h"
+#include "Report.h"
+#include "Money.h"
+
+// Buffer size for generated stock item IDs
+const int BENCHMARK_ID_BUFFER = 24;
+// Buffer size for lines and words of the stdio sales reader
+#define BENCHMARK_LINE_BUFFER 64
+#define BENCHMARK_STRING_BUFFER 32
+// Temporary file used by file loading benchmarks
+const char *BENCHMARK_SALES_FILE = "benchmark_sales.txt";
+
+/**
+ * Method to get the current time in seconds, used to time benchmarks.
+ * 
+ * @return Current time in seconds.
+ */
+static double benchmark_now() {
+    struct timespec time;
+    timespec_get(&time, TIME_UTC);
+    
+    return time.tv_sec + (time.tv_nsec / 1e9);
+}
+
+/**
+ * Method to create a inventory filled with generated stock items of 
+ * random quantity and price.
+ * 
+ * @param  Integer number of stock items to generate.
+ * @return Pointer to newly created inventory.
+ */
+static Inventory *benchmark_inventory(int count) {
+    static char *types[] = { "resistor", "capacitor", "diode", 
+            "transistor", "IC" };
+    Inventory *inventory = inventory_new();
+    
+    for (int i = 0; i < count; i++) {
+        char *ID = (char*)malloc(sizeof(char) * BENCHMARK_ID_BUFFER);
+        snprintf(ID, BENCHMARK_ID_BUFFER, "BENCH_%d", i);
+        
+        inventory_add(inventory, stockItem_new(types[rand() % 5], ID, 
+                rand() % 1000, 1 + rand() % 10000, "N/A"));
+    }
+    
+    return inventory;
+}
+
+/**
+ * Method to free a generated inventory along with its stock items.
+ * 
+ * @param Pointer to inventory to be freed.
+ */
+static void benchmark_freeInventory(Inventory *inventory) {
+    // Free inventory before the stock items it refers to
+    int count = inventory_itemCount(inventory);
+    StockItem **items = (StockItem**)malloc(sizeof(StockItem*) 
+            * (count ? count : 1));
+    // Null check memory allocation
+    if (!items) {
+        fprintf(stderr, "Error: Unable to allocate memory in "
+                "benchmark_freeInventory().\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < count; i++)
+        items[i] = inventory_getItem(inventory, i);
+    
+    inventory_free(inventory);
+    for (int i = 0; i < count; i++)
+        if (items[i]) {
+            free(stockItem_getID(items[i]));
+            stockItem_free(items[i]);
+        }
+    free(items);
+}
+
+/**
+ * Method to put the stock items of a inventory back in a given order, by
+ * emptying it and adding them again.
+ * 
+ * @param Pointer to inventory.
+ * @param Array of stock items in order.
+ * @param Integer number of stock items.
+ */
+static void benchmark_restoreOrder(Inventory *inventory, StockItem **items,
+        int count) {
+    inventory_clear(inventory);
+    for (int i = 0; i < count; i++)
+        inventory_add(inventory, items[i]);
+}
+
+/**
+ * Method to benchmark sorting inventories of 1k, 100k and 1M stock items
+ * on every sort key.
+ */
+static void benchmark_sort() {
+    static const char *keys[] = { "price", "quantity", "type", "ID", 
+            "value" };
+    static const int sizes[] = { 1000, 100000, 1000000 };
+    
+    printf("\nBENCHMARK: inventory_sortBy()\n");
+    printf("%10s %10s %12s %12s\n", "Items", "Key", "Ascending", 
+            "Descending");
+    
+    for (int s = 0; s < 3; s++) {
+        srand(1);
+        Inventory *inventory = benchmark_inventory(sizes[s]);
+        
+        // Keep generated order so each timing starts from it
+        StockItem **items = (StockItem**)malloc(sizeof(StockItem*) 
+                * sizes[s]);
+        // Null check memory allocation
+        if (!items) {
+            fprintf(stderr, "Error: Unable to allocate memory in "
+                    "benchmark_sort().\n");
+            exit(EXIT_FAILURE);
+        }
+        for (int i = 0; i < sizes[s]; i++)
+            items[i] = inventory_getItem(inventory, i);
+        
+        for (int key = INVENTORY_SORT_PRICE; key <= INVENTORY_SORT_VALUE; 
+                key++) {
+            benchmark_restoreOrder(inventory, items, sizes[s]);
+            double start = benchmark_now();
+            inventory_sortBy(inventory, key, INVENTORY_SORT_ASCENDING);
+            double ascending = benchmark_now() - start;
+            
+            benchmark_restoreOrder(inventory, items, sizes[s]);
+            start = benchmark_now();
+            inventory_sortBy(inventory, key, INVENTORY_SORT_DESCENDING);
+            double descending = benchmark_now() - start;
+            
+            printf("%10d %10s %11.4fs %11.4fs\n", sizes[s], keys[key], 
+                    ascending, descending);
+        }
+        
+        benchmark_freeInventory(inventory);
+        free(items);
+    }
+}
+
+/**
+ * Method to write a sales file of generated sales against a generated 
+ * inventory.
+ * 
+ * @param  Integer number of sales lines to write.
+ * @param  Integer number of stock items sales are spread over.
+ * @return Size of file written in bytes.
+ */
+static long benchmark_writeSales(int count, int items) {
+    FILE *file = fopen(BENCHMARK_SALES_FILE, "w");
+    if (!file) {
+        fprintf(stderr, "Error: Unable to open '%s' in mode 'w' "
+                "in benchmark_writeSales().\n", BENCHMARK_SALES_FILE);
+        exit(EXIT_FAILURE);
+    }
+    
+    for (int i = 0; i < count; i++)
+        fprintf(file, "%02d/%02d/%04d, BENCH_%d,%d\r\n", 1 + rand() % 28, 
+                1 + rand() % 12, 1980 + rand() % 40, rand() % items, 
+                1 + rand() % 5);
+    
+    long size = ftell(file);
+    fclose(file);
+    
+    return size;
+}
+
+/**
+ * Method to read sales the way the program originally did, with fgets, a
+ * malloc per field and sscanf, used as the baseline for loader_readSales().
+ * 
+ * @param Pointer to sales list where all sales will be added to.
+ * @param Pointer to inventory containing stock items sold.
+ * @param File name of file to be read. 
+ */
+static void benchmark_readSalesStdio(Sales* sales, Inventory* inventory, 
+        const char *fileName) {
+    FILE *file = fopen(fileName, "r");
+    char line[BENCHMARK_LINE_BUFFER];
+    
+    while (fgets(line, BENCHMARK_LINE_BUFFER, file)) {
+        char *day = (char*)malloc(sizeof(char) * BENCHMARK_STRING_BUFFER);
+        char *month = (char*)malloc(sizeof(char) * BENCHMARK_STRING_BUFFER);
+        char *year = (char*)malloc(sizeof(char) * BENCHMARK_STRING_BUFFER);
+        char *ID = (char*)malloc(sizeof(char) * BENCHMARK_STRING_BUFFER);
+        char *quantity = (char*)malloc(sizeof(char) 
+                * BENCHMARK_STRING_BUFFER);
+        
+        sscanf(line, "%[^/]/%[^/]/%[^, \t\n], %[^,\t\n], %[^ \t\n]", 
+                day, month, year, ID, quantity);
+        sales_add(sales, inventory, date_new(atoi(day), atoi(month), 
+                atoi(year)), ID, atoi(quantity));
+        
+        free(day);
+        free(month);
+        free(year);
+        free(quantity);
+    }
+    
+    fclose(file);
+}
+
+/**
+ * Method to time reading the benchmark sales file into a fresh inventory
+ * and sales list with the given reader.
+ * 
+ * @param  Reader to be timed.
+ * @param  Integer number of stock items to generate.
+ * @return Time taken in seconds.
+ */
+static double benchmark_timeSales(void (*reader)(Sales*, Inventory*, 
+        const char*), int items) {
+    srand(2);
+    Inventory *inventory = benchmark_inventory(items);
+    Sales *sales = sales_new();
+    
+    double start = benchmark_now();
+    reader(sales, inventory, BENCHMARK_SALES_FILE);
+    double time = benchmark_now() - start;
+    
+    sales_free(sales);
+    benchmark_freeInventory(inventory);
+    
+    return time;
+}
+
+// Stage statistics of the last pipelined load timed
+static LoaderPipelineStats benchmark_pipelineStats;
+
+/**
+ * Method to read sales with loader_readSalesPipelined(), keeping its stage
+ * statistics in benchmark_pipelineStats.
+ * 
+ * @param Pointer to sales list where all sales will be added to.
+ * @param Pointer to inventory containing stock items sold.
+ * @param File name of file to be read. 
+ */
+static void benchmark_readSalesPipelined(Sales* sales, Inventory* inventory,
+        const char *fileName) {
+    loader_readSalesPipelined(sales, inventory, fileName, 
+            &benchmark_pipelineStats);
+}
+
+/**
+ * Method to check two readers make the same sales from the benchmark 
+ * sales file and leave the same stock.
+ * 
+ * @param  First reader.
+ * @param  Second reader.
+ * @param  Integer number of stock items to generate.
+ * @return 1 if results match or 0 if not.
+ */
+static int benchmark_sameSales(void (*first)(Sales*, Inventory*, 
+        const char*), void (*second)(Sales*, Inventory*, const char*), 
+        int items) {
+    srand(2);
+    Inventory *firstInventory = benchmark_inventory(items);
+    srand(2);
+    Inventory *secondInventory = benchmark_inventory(items);
+    Sales *firstSales = sales_new(), *secondSales = sales_new();
+    
+    first(firstSales, firstInventory, BENCHMARK_SALES_FILE);
+    second(secondSales, secondInventory, BENCHMARK_SALES_FILE);
+    
+    int match = sales_count(firstSales) == sales_count(secondSales);
+    for (int i = 0; match && (i < items); i++)
+        match = stockItem_getQuantity(inventory_getItem(firstInventory, i))
+                == stockItem_getQuantity(inventory_getItem(secondInventory, 
+                i));
+    
+    sales_free(firstSales);
+    sales_free(secondSales);
+    benchmark_freeInventory(firstInventory);
+    benchmark_freeInventory(secondInventory);
+    
+    return match;
+}
+
+/**
+ * Method to benchmark loading a large sales file with loader_readSales()
+ * against the original stdio reader, the pipelined reader and a plain 
+ * read of the file, printing the statistics of each pipeline stage.
+ */
+static void benchmark_load() {
+    const int lines = 1000000, items = 1000;
+    
+    srand(3);
+    long size = benchmark_writeSales(lines, items);
+    double megabytes = size / 1e6;
+    
+    // Time reading the file alone as the bandwidth ceiling
+    char *buffer = (char*)malloc(size);
+    double start = benchmark_now();
+    FILE *file = fopen(BENCHMARK_SALES_FILE, "rb");
+    size_t read = fread(buffer, 1, size, file);
+    fclose(file);
+    double readTime = benchmark_now() - start;
+    free(buffer);
+    
+    double stdioTime  = benchmark_timeSales(benchmark_readSalesStdio, items);
+    double mappedTime = benchmark_timeSales(loader_readSales, items);
+    double pipedTime  = benchmark_timeSales(benchmark_readSalesPipelined, 
+            items);
+    int match = benchmark_sameSales(loader_readSales, 
+            benchmark_readSalesPipelined, items);
+    
+    printf("\nBENCHMARK: loader_readSales() on %d lines (%.1fMB)\n", lines, 
+            megabytes);
+    printf("%18s %10s %10s %14s\n", "Reader", "Time", "MB/s", "Lines/s");
+    printf("%18s %9.4fs %10.1f %14.0f\n", "fread only", readTime, 
+            read / 1e6 / readTime, lines / readTime);
+    printf("%18s %9.4fs %10.1f %14.0f\n", "fgets + sscanf", stdioTime, 
+            megabytes / stdioTime, lines / stdioTime);
+    printf("%18s %9.4fs %10.1f %14.0f\n", "mmap + scanner", mappedTime, 
+            megabytes / mappedTime, lines / mappedTime);
+    printf("%18s %9.4fs %10.1f %14.0f\n", "pipelined", pipedTime, 
+            megabytes / pipedTime, lines / pipedTime);
+    printf("%18s %10s\n", "check", match ? "results match" : "MISMATCH");
+    
+    // Report pipeline stages of last load
+    const LoaderStageStats *stages[] = { &benchmark_pipelineStats.read, 
+            &benchmark_pipelineStats.parse, &benchmark_pipelineStats.apply };
+    const char *names[] = { "read", "parse", "apply" };
+    printf("%18s %10s %12s %12s %10s\n", "Stage", "Items", "In stalls", 
+            "Out stalls", "Occupancy");
+    for (int i = 0; i < 3; i++)
+        printf("%18s %10ld %12ld %12ld %10.2f\n", names[i], 
+                stages[i]->items, stages[i]->inputStalls, 
+                stages[i]->outputStalls, stages[i]->occupancy);
+    
+    remove(BENCHMARK_SALES_FILE);
+}
+
+/**
+ * Method to benchmark loading a large sales file with 
+ * loader_readSalesParallel() on 1 thread doubling up to one per processor,
+ * printing the time of each phase.
+ */
+static void benchmark_parallel() {
+    const int lines = 4000000, items = 1000;
+    int processors = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    
+    srand(4);
+    long size = benchmark_writeSales(lines, items);
+    
+    printf("\nBENCHMARK: loader_readSalesParallel() on %d lines (%.1fMB)\n",
+            lines, size / 1e6);
+    printf("%8s %10s %10s %10s %10s %14s\n", "Threads", "Map", "Parse", 
+            "Apply", "Total", "Parse speedup");
+    
+    double parseOne = 0;
+    for (int threads = 1; ; threads *= 2) {
+        // Finish on exactly one thread per processor
+        if (threads > processors)
+            threads = processors;
+        
+        srand(2);
+        Inventory *inventory = benchmark_inventory(items);
+        Sales *sales = sales_new();
+        LoaderTimings timings;
+        loader_readSalesParallel(sales, inventory, BENCHMARK_SALES_FILE, 
+                threads, &timings);
+        sales_free(sales);
+        benchmark_freeInventory(inventory);
+        
+        if (threads == 1)
+            parseOne = timings.parse;
+        printf("%8d %9.4fs %9.4fs %9.4fs %9.4fs %13.2fx\n", threads, 
+                timings.map, timings.parse, timings.apply, timings.total, 
+                parseOne / timings.parse);
+        
+        if (threads >= processors)
+            break;
+    }
+    
+    remove(BENCHMARK_SALES_FILE);
+}
+
+/**
+ * Method to append generated sales of stock items from a generated 
+ * inventory directly to a sales list, spread over 40 years from 1980. 
+ * Stock is not taken, so every sale is kept.
+ * 
+ * @param Pointer to sales list to be appended to.
+ * @param Pointer to inventory containing stock items sold.
+ * @param Integer number of sales to generate.
+ */
+static void benchmark_sales(Sales *sales, const Inventory *inventory, 
+        int count) {
+    int items = inventory_itemCount(inventory);
+    
+    sales_reserve(sales, count);
+    for (int i = 0; i < count; i++)
+        sales_append(sales, inventory_getItem(inventory, rand() % items), 
+                date_new(1 + rand() % 28, 1 + rand() % 12, 
+                1980 + rand() % 40), 1 + rand() % 5);
+}
+
+/**
+ * Method to benchmark monthly revenue totals for one year, scanning every
+ * sale for each month against using a date index.
+ */
+static void benchmark_range() {
+    const int count = 4000000, items = 1000, year = 1995;
+    
+    srand(5);
+    Inventory *inventory = benchmark_inventory(items);
+    Sales *sales = sales_new();
+    benchmark_sales(sales, inventory, count);
+    
+    double start = benchmark_now();
+    SalesIndex *index = salesIndex_new(sales);
+    double buildTime = benchmark_now() - start;
+    
+    // Total each month by scanning all sales
+    Money scanTotal = 0;
+    start = benchmark_now();
+    for (int month = 1; month <= 12; month++) {
+        Date from = date_new(1, month, year);
+        Date to = ((month < 12) ? date_new(1, month + 1, year) 
+                : date_new(1, 1, year + 1)) - 1;
+        for (SalesIterator i = sales_first(sales); i != NULL; 
+                i = sales_iteratorNext(i))
+            if ((i->date >= from) && (i->date <= to))
+                scanTotal += sales_getTotal(i);
+    }
+    double scanTime = benchmark_now() - start;
+    
+    // Total each month with index
+    Money indexTotal = 0;
+    start = benchmark_now();
+    for (int month = 1; month <= 12; month++) {
+        Date from = date_new(1, month, year);
+        Date to = ((month < 12) ? date_new(1, month + 1, year) 
+                : date_new(1, 1, year + 1)) - 1;
+        indexTotal += salesIndex_revenue(index, from, to);
+    }
+    double indexTime = benchmark_now() - start;
+    
+    printf("\nBENCHMARK: monthly revenue for %d over %d sales\n", year, 
+            count);
+    printf("%18s %10s %16s\n", "Method", "Time", "Total (pennies)");
+    printf("%18s %9.4fs %16s\n", "build index", buildTime, "");
+    printf("%18s %9.4fs %16lld\n", "full scan", scanTime, 
+            (long long)scanTotal);
+    printf("%18s %9.4fs %16lld\n", "date index", indexTime, 
+            (long long)indexTotal);
+    
+    salesIndex_free(index);
+    sales_free(sales);
+    benchmark_freeInventory(inventory);
+}
+
+/**
+ * Method to check a rollup against a scan of its sales list, comparing the
+ * totals of every component type, and of all types, over one year.
+ * 
+ * @param  Pointer to rollup to be checked.
+ * @param  Full year integer value, such as 2017.
+ * @return 1 if all totals match or 0 if not.
+ */
+static int benchmark_rollupMatches(SalesRollup *rollup, int year) {
+    Date from = date_new(1, 1, year), to = date_new(31, 12, year);
+    
+    for (int type = COMPONENT_TYPE_NONE; type < componentType_count(); 
+            type++) {
+        SalesRollupTotal scanned = { 0, 0 };
+        for (SalesIterator i = sales_first(rollup->sales); i != NULL; 
+                i = sales_iteratorNext(i))
+            if ((i->date >= from) && (i->date <= to) 
+                    && ((type == COMPONENT_TYPE_NONE) 
+                        || (stockItem_getTypeCode(i->item) == type))) {
+                scanned.revenue += sales_getTotal(i);
+                scanned.units   += i->quantity;
+            }
+        
+        SalesRollupTotal total = salesRollup_year(rollup, type, year);
+        if ((total.revenue != scanned.revenue) 
+                || (total.units != scanned.units))
+            return 0;
+    }
+    
+    return 1;
+}
+
+/**
+ * Method to benchmark random date range totals per component type with a
+ * rollup against a date index, then the cost of bringing the rollup up to
+ * date after more sales are appended. Checks the rollup against a scan
+ * after appends and after sales are inserted and removed.
+ */
+static void benchmark_rollup() {
+    const int count = 4000000, items = 1000, queries = 100000, 
+            appended = 10000;
+    
+    srand(6);
+    Inventory *inventory = benchmark_inventory(items);
+    Sales *sales = sales_new();
+    benchmark_sales(sales, inventory, count);
+    
+    double start = benchmark_now();
+    SalesRollup *rollup = salesRollup_new(sales);
+    salesRollup_update(rollup);
+    double buildTime = benchmark_now() - start;
+    
+    // Generate random ranges over all types, including all types at once
+    Date *ranges = (Date*)malloc(sizeof(Date) * queries * 2);
+    int *types = (int*)malloc(sizeof(int) * queries);
+    Date first = date_new(1, 1, 1980), last = date_new(31, 12, 2019);
+    for (int i = 0; i < queries; i++) {
+        Date from = first + rand() % (last - first + 1);
+        ranges[i * 2]     = from;
+        ranges[i * 2 + 1] = from + rand() % (last - from + 1);
+        types[i] = rand() % (componentType_count() + 1) - 1;
+    }
+    
+    Money rollupTotal = 0;
+    start = benchmark_now();
+    for (int i = 0; i < queries; i++)
+        rollupTotal += salesRollup_range(rollup, types[i], ranges[i * 2], 
+                ranges[i * 2 + 1]).revenue;
+    double rollupTime = benchmark_now() - start;
+    
+    // Index only answers all types at once, so time it on a sample
+    const int sampled = 100;
+    SalesIndex *index = salesIndex_new(sales);
+    Money indexTotal = 0, sampleTotal = 0;
+    start = benchmark_now();
+    for (int i = 0; i < sampled; i++)
+        indexTotal += salesIndex_revenue(index, ranges[i * 2], 
+                ranges[i * 2 + 1]);
+    double indexTime = (benchmark_now() - start) * queries / sampled;
+    for (int i = 0; i < sampled; i++)
+        sampleTotal += salesRollup_range(rollup, COMPONENT_TYPE_NONE, 
+                ranges[i * 2], ranges[i * 2 + 1]).revenue;
+    
+    // Append sales and time bringing rollup up to date
+    benchmark_sales(sales, inventory, appended);
+    start = benchmark_now();
+    salesRollup_update(rollup);
+    double updateTime = benchmark_now() - start;
+    int appendMatches = benchmark_rollupMatches(rollup, 1995);
+    
+    // Change sales without appending, keeping the count the same, which 
+    // the rollup must detect
+    sales_removeHead(sales);
+    benchmark_sales(sales, inventory, 1);
+    sales_insert(sales, inventory, date_new(1, 6, 1995), 
+            stockItem_getID(inventory_getItem(inventory, 0)), 1);
+    sales_removeTail(sales);
+    int changeMatches = benchmark_rollupMatches(rollup, 1995);
+    
+    printf("\nBENCHMARK: %d random date range totals over %d sales\n", 
+            queries, count);
+    printf("%26s %10s %16s\n", "Method", "Time", "Check");
+    printf("%26s %9.4fs\n", "build rollup", buildTime);
+    printf("%26s %9.4fs %16lld\n", "rollup queries", rollupTime, 
+            (long long)rollupTotal);
+    printf("%26s %9.4fs %16s\n", "date index (estimated)", indexTime, 
+            (indexTotal == sampleTotal) ? "totals match" : "MISMATCH");
+    printf("%26s %9.4fs %16s\n", "update after 10000 appends", updateTime,
+            appendMatches ? "totals match" : "MISMATCH");
+    printf("%26s %10s %16s\n", "after insert and remove", "", 
+            changeMatches ? "totals match" : "MISMATCH");
+    
+    free(ranges);
+    free(types);
+    salesIndex_free(index);
+    salesRollup_free(rollup);
+    sales_free(sales);
+    benchmark_freeInventory(inventory);
+}
+
+/**
+ * Structure defining the work of one thread selling a contended stock item.
+ */
+typedef struct BenchmarkSellerStruct {
+    StockItem *item;
+    int attempts, seed;
+    // Units sold and sales refused for lack of stock
+    long long sold, refused;
+}
+BenchmarkSeller;
+
+/**
+ * Thread method selling random small quantities of a stock item, counting
+ * units sold and sales refused.
+ * 
+ * @param  Pointer to BenchmarkSeller of thread.
+ * @return Null.
+ */
+static void *benchmark_sell(void *argument) {
+    BenchmarkSeller *seller = (BenchmarkSeller*)argument;
+    unsigned int seed = (unsigned int)seller->seed;
+    
+    for (int i = 0; i < seller->attempts; i++) {
+        int quantity = 1 + rand_r(&seed) % 3;
+        if (stockItem_Sell(seller->item, quantity))
+            seller->sold += quantity;
+        else
+            seller->refused++;
+    }
+    
+    return NULL;
+}
+
+/**
+ * Method to compare two stock item totals by revenue for qsort(), highest
+ * first and equal totals in the order stock items were added.
+ * 
+ * @param  Pointer to first stock item totals.
+ * @param  Pointer to second stock item totals.
+ * @return Negative, 0 or positive as first ranks above, with or below.
+ */
+static int benchmark_compareRevenue(const void *seller1, const void *seller2) {
+    const TopSeller *a = (const TopSeller*)seller1;
+    const TopSeller *b = (const TopSeller*)seller2;
+    if (a->revenue != b->revenue)
+        return (a->revenue > b->revenue) ? -1 : 1;
+    return stockItem_getIndex(a->item) - stockItem_getIndex(b->item);
+}
+
+/**
+ * Method to compare two stock item totals by units for qsort(), highest
+ * first and equal totals in the order stock items were added.
+ * 
+ * @param  Pointer to first stock item totals.
+ * @param  Pointer to second stock item totals.
+ * @return Negative, 0 or positive as first ranks above, with or below.
+ */
+static int benchmark_compareUnits(const void *seller1, const void *seller2) {
+    const TopSeller *a = (const TopSeller*)seller1;
+    const TopSeller *b = (const TopSeller*)seller2;
+    if (a->units != b->units)
+        return (a->units > b->units) ? -1 : 1;
+    return stockItem_getIndex(a->item) - stockItem_getIndex(b->item);
+}
+
+/**
+ * Method to find the top stock items by totalling every stock item and
+ * sorting all of them, as a check on topSellers_find().
+ * 
+ * @param  Pointer to inventory containing stock items sold.
+ * @param  Pointer to sales list to be totalled.
+ * @param  Pointer to filter sales must match.
+ * @param  Measure stock items are ranked on.
+ * @param  Array of one total per stock item where stock items with sales
+ *         will be stored, highest first.
+ * @return Integer number of stock items with sales.
+ */
+static int benchmark_sortSellers(const Inventory *inventory, 
+        const Sales *sales, const TopSellersFilter *filter, 
+        TopSellersMeasure measure, TopSeller *all) {
+    int items = inventory_itemCount(inventory);
+    for (int i = 0; i < items; i++)
+        all[i] = (TopSeller){ inventory_getItem(inventory, i), 0, 0 };
+    
+    for (SalesIterator i = sales_first(sales); i != NULL; 
+            i = sales_iteratorNext(i))
+        if ((i->date >= filter->from) && (i->date <= filter->to) 
+                && ((filter->type == COMPONENT_TYPE_NONE) 
+                    || (stockItem_getTypeCode(i->item) == filter->type))) {
+            TopSeller *seller = &all[stockItem_getIndex(i->item)];
+            seller->revenue += sales_getTotal(i);
+            seller->units   += i->quantity;
+        }
+    
+    // Drop stock items without sales, then sort the rest
+    int found = 0;
+    for (int i = 0; i < items; i++)
+        if (all[i].units != 0)
+            all[found++] = all[i];
+    qsort(all, found, sizeof(TopSeller), (measure == TOP_SELLERS_REVENUE) 
+            ? benchmark_compareRevenue : benchmark_compareUnits);
+    
+    return found;
+}
+
+/**
+ * Method to benchmark finding the top 20 stock items with topSellers_find()
+ * against totalling and sorting every stock item, for all sales by 
+ * revenue, a quarter by revenue and one type by units. Checks both find 
+ * the same stock items with the same totals in the same order.
+ */
+static void benchmark_topsellers() {
+    const int count = 4000000, items = 100000, wanted = 20;
+    
+    srand(11);
+    Inventory *inventory = benchmark_inventory(items);
+    Sales *sales = sales_new();
+    benchmark_sales(sales, inventory, count);
+    
+    const char *names[] = { "all sales by revenue", "quarter by revenue", 
+            "resistors by units" };
+    TopSellersFilter filters[] = {
+        { date_new(1, 1, 1980), date_new(31, 12, 2019), COMPONENT_TYPE_NONE },
+        { date_new(1, 10, 1995), date_new(31, 12, 1995), COMPONENT_TYPE_NONE },
+        { date_new(1, 1, 1980), date_new(31, 12, 2019), 
+            componentType_intern("resistor") }
+    };
+    TopSellersMeasure measures[] = { TOP_SELLERS_REVENUE, TOP_SELLERS_REVENUE,
+            TOP_SELLERS_UNITS };
+    
+    TopSeller top[20];
+    TopSeller *all = (TopSeller*)malloc(sizeof(TopSeller) * items);
+    
+    printf("\nBENCHMARK: top %d of %d stock items over %d sales\n", wanted, 
+            items, count);
+    printf("%22s %10s %10s %16s\n", "Query", "Heap", "Full sort", "Check");
+    for (int query = 0; query < 3; query++) {
+        double start = benchmark_now();
+        int found = topSellers_find(inventory, sales, &filters[query], 
+                measures[query], wanted, top);
+        double heapTime = benchmark_now() - start;
+        
+        start = benchmark_now();
+        int sorted = benchmark_sortSellers(inventory, sales, &filters[query],
+                measures[query], all);
+        double sortTime = benchmark_now() - start;
+        
+        int match = found == ((sorted < wanted) ? sorted : wanted);
+        for (int i = 0; match && (i < found); i++)
+            match = (top[i].item == all[i].item) 
+                    && (top[i].revenue == all[i].revenue) 
+                    && (top[i].units == all[i].units);
+        
+        printf("%22s %9.4fs %9.4fs %16s\n", names[query], heapTime, sortTime,
+                match ? "results match" : "MISMATCH");
+    }
+    
+    free(all);
+    sales_free(sales);
+    benchmark_freeInventory(inventory);
+}
+
+/**
+ * Method to stress stockItem_Sell() with one thread per processor, and at
+ * least 4, selling the same stock item at once, more than is in stock.
+ * Checks no units are oversold or lost and the stock item's aggregate
+ * matches its quantity.
+ */
+static void benchmark_contention() {
+    const int stock = 1000000, attempts = 1000000;
+    int threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (threads < 4)
+        threads = 4;
+    
+    Inventory *inventory = inventory_new();
+    StockItem *item = stockItem_new("resistor", "BENCH_HOT", stock, 1, 
+            "1K");
+    inventory_add(inventory, item);
+    int inStock = inventory_registerAggregate(inventory, AGGREGATE_QUANTITY, 
+            aggregate_filter, &(AggregateFilter){ COMPONENT_TYPE_NONE, 
+            ATTRIBUTE_NONE, 0, 0 });
+    
+    BenchmarkSeller *sellers = (BenchmarkSeller*)calloc(threads, 
+            sizeof(BenchmarkSeller));
+    pthread_t *workers = (pthread_t*)malloc(sizeof(pthread_t) * threads);
+    // Null check memory allocation
+    if (!sellers || !workers) {
+        fprintf(stderr, "Error: Unable to allocate memory in "
+                "benchmark_contention().\n");
+        exit(EXIT_FAILURE);
+    }
+    
+    double start = benchmark_now();
+    for (int i = 0; i < threads; i++) {
+        sellers[i].item     = item;
+        sellers[i].attempts = attempts;
+        sellers[i].seed     = i + 1;
+        if (pthread_create(&workers[i], NULL, benchmark_sell, 
+                &sellers[i]) != 0) {
+            fprintf(stderr, "Error: Unable to start thread in "
+                    "benchmark_contention().\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    for (int i = 0; i < threads; i++)
+        pthread_join(workers[i], NULL);
+    double time = benchmark_now() - start;
+    
+    long long sold = 0, refused = 0;
+    for (int i = 0; i < threads; i++) {
+        sold    += sellers[i].sold;
+        refused += sellers[i].refused;
+    }
+    int left = stockItem_getQuantity(item);
+    
+    printf("\nBENCHMARK: %d threads selling one stock item of %d units\n", 
+            threads, stock);
+    printf("%18s %9.4fs\n", "time", time);
+    printf("%18s %10lld\n", "units sold", sold);
+    printf("%18s %10lld\n", "sales refused", refused);
+    printf("%18s %10d\n", "units left", left);
+    printf("%18s %10s\n", "check", ((left >= 0) && (sold + left == stock)
+            && (inventory_getAggregate(inventory, inStock) == left))
+            ? "no overselling" : "OVERSOLD");
+    
+    free(sellers);
+    free(workers);
+    inventory_free(inventory);
+    stockItem_free(item);
+}
+
+/**
+ * Structure defining the work of one thread using a sharded inventory.
+ */
+typedef struct BenchmarkWriterStruct {
+    ShardedInventory *sharded;
+    // IDs of stock items in inventory before threads start
+    char **IDs;
+    int items, operations, seed, thread;
+    // Stock items added by thread and their number
+    StockItem **added;
+    int addedCount;
+}
+BenchmarkWriter;
+
+/**
+ * Thread method making random operations on a sharded inventory: 40% 
+ * sales, 40% restocks, 15% finds and 5% adds of new stock items.
+ * 
+ * @param  Pointer to BenchmarkWriter of thread.
+ * @return Null.
+ */
+static void *benchmark_write(void *argument) {
+    BenchmarkWriter *writer = (BenchmarkWriter*)argument;
+    unsigned int seed = (unsigned int)writer->seed;
+    
+    for (int i = 0; i < writer->operations; i++) {
+        int operation = rand_r(&seed) % 100;
+        const char *ID = writer->IDs[rand_r(&seed) % writer->items];
+        
+        if (operation < 40)
+            shardedInventory_sell(writer->sharded, ID, 1);
+        else if (operation < 80)
+            shardedInventory_restock(writer->sharded, ID, 1);
+        else if (operation < 95)
+            shardedInventory_find(writer->sharded, ID);
+        else {
+            char *newID = (char*)malloc(sizeof(char) * BENCHMARK_ID_BUFFER);
+            snprintf(newID, BENCHMARK_ID_BUFFER, "BENCH_%d_%d", 
+                    writer->thread, writer->addedCount);
+            StockItem *item = stockItem_new("resistor", newID, 100, 1, 
+                    NULL);
+            shardedInventory_add(writer->sharded, item);
+            writer->added[writer->addedCount++] = item;
+        }
+    }
+    
+    return NULL;
+}
+
+/**
+ * Method to time threads making random operations on a sharded inventory
+ * of generated stock items.
+ * 
+ * @param  Integer number of shards.
+ * @param  Integer number of writer threads.
+ * @param  Array of IDs of generated stock items.
+ * @param  Integer number of generated stock items.
+ * @param  Integer number of operations made by each thread.
+ * @return Time taken in seconds.
+ */
+static double benchmark_timeWriters(int shards, int threads, char **IDs, 
+        int items, int operations) {
+    ShardedInventory *sharded = shardedInventory_new(shards);
+    StockItem **generated = (StockItem**)malloc(sizeof(StockItem*) * items);
+    BenchmarkWriter *writers = (BenchmarkWriter*)calloc(threads, 
+            sizeof(BenchmarkWriter));
+    pthread_t *workers = (pthread_t*)malloc(sizeof(pthread_t) * threads);
+    // Null check memory allocation
+    if (!generated || !writers || !workers) {
+        fprintf(stderr, "Error: Unable to allocate memory in "
+                "benchmark_timeWriters().\n");
+        exit(EXIT_FAILURE);
+    }
+    
+    for (int i = 0; i < items; i++) {
+        generated[i] = stockItem_new("resistor", IDs[i], 1000000, 1, NULL);
+        shardedInventory_add(sharded, generated[i]);
+    }
+    
+    double start = benchmark_now();
+    for (int i = 0; i < threads; i++) {
+        writers[i] = (BenchmarkWriter){ sharded, IDs, items, operations, 
+                i + 1, i, (StockItem**)malloc(sizeof(StockItem*) 
+                * operations), 0 };
+        if (!writers[i].added 
+                || (pthread_create(&workers[i], NULL, benchmark_write, 
+                    &writers[i]) != 0)) {
+            fprintf(stderr, "Error: Unable to start thread in "
+                    "benchmark_timeWriters().\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    for (int i = 0; i < threads; i++)
+        pthread_join(workers[i], NULL);
+    double time = benchmark_now() - start;
+    
+    // Free inventory before the stock items it refers to
+    shardedInventory_free(sharded);
+    for (int i = 0; i < threads; i++) {
+        for (int j = 0; j < writers[i].addedCount; j++) {
+            free(stockItem_getID(writers[i].added[j]));
+            stockItem_free(writers[i].added[j]);
+        }
+        free(writers[i].added);
+    }
+    for (int i = 0; i < items; i++)
+        stockItem_free(generated[i]);
+    free(generated);
+    free(writers);
+    free(workers);
+    
+    return time;
+}
+
+/**
+ * Method to benchmark throughput of 1 to 32 writer threads sharing a 
+ * inventory, with a single shard, so one lock, and with the default 
+ * number of shards.
+ */
+static void benchmark_sharded() {
+    const int items = 10000, operations = 200000;
+    
+    char **IDs = (char**)malloc(sizeof(char*) * items);
+    // Null check memory allocation
+    if (!IDs) {
+        fprintf(stderr, "Error: Unable to allocate memory in "
+                "benchmark_sharded().\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < items; i++) {
+        IDs[i] = (char*)malloc(sizeof(char) * BENCHMARK_ID_BUFFER);
+        snprintf(IDs[i], BENCHMARK_ID_BUFFER, "BENCH_%d", i);
+    }
+    
+    printf("\nBENCHMARK: sharded inventory, %d operations per thread on "
+            "%d stock items\n", operations, items);
+    printf("%8s %16s %16s %10s\n", "Threads", "1 shard (op/s)", 
+            "64 shards (op/s)", "Scaling");
+    
+    double one = 0;
+    for (int threads = 1; threads <= 32; threads *= 2) {
+        double single = benchmark_timeWriters(1, threads, IDs, items, 
+                operations);
+        double sharded = benchmark_timeWriters(
+                SHARDED_INVENTORY_DEFAULT_SHARDS, threads, IDs, items, 
+                operations);
+        double total = (double)operations * threads;
+        
+        if (threads == 1)
+            one = total / sharded;
+        printf("%8d %16.0f %16.0f %9.2fx\n", threads, total / single, 
+                total / sharded, total / sharded / one);
+    }
+    
+    for (int i = 0; i < items; i++)
+        free(IDs[i]);
+    free(IDs);
+}
+
+/**
+ * Method to benchmark making generated sales one at a time with 
+ * sales_add() against batches of sales_addBatch(), in a feed where sales
+ * of the same stock item often come together. Checks both make the same
+ * sales and leave the same stock.
+ */
+static void benchmark_batch() {
+    const int count = 2000000, items = 1000, batch = 4096;
+    
+    // Generate runs of 1 to 4 sales of the same stock item
+    srand(5);
+    char **IDs = (char**)malloc(sizeof(char*) * items);
+    SaleRequest *requests = (SaleRequest*)malloc(sizeof(SaleRequest) 
+            * count);
+    unsigned char *accepted = (unsigned char*)malloc(batch);
+    // Null check memory allocation
+    if (!IDs || !requests || !accepted) {
+        fprintf(stderr, "Error: Unable to allocate memory in "
+                "benchmark_batch().\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < items; i++) {
+        IDs[i] = (char*)malloc(sizeof(char) * BENCHMARK_ID_BUFFER);
+        snprintf(IDs[i], BENCHMARK_ID_BUFFER, "BENCH_%d", i);
+    }
+    for (int i = 0; i < count; ) {
+        const char *ID = IDs[rand() % items];
+        for (int run = 1 + rand() % 4; (run > 0) && (i < count); run--, i++)
+            requests[i] = (SaleRequest){ date_new(1 + rand() % 28, 
+                    1 + rand() % 12, 1980 + rand() % 40), ID, 
+                    1 + rand() % 5 };
+    }
+    
+    // Make sales one at a time
+    srand(2);
+    Inventory *single = benchmark_inventory(items);
+    Sales *singleSales = sales_new();
+    double start = benchmark_now();
+    for (int i = 0; i < count; i++)
+        sales_add(singleSales, single, requests[i].date, 
+                (char*)requests[i].ID, requests[i].quantity);
+    double singleTime = benchmark_now() - start;
+    
+    // Make sales in batches
+    srand(2);
+    Inventory *batched = benchmark_inventory(items);
+    Sales *batchedSales = sales_new();
+    int made = 0;
+    start = benchmark_now();
+    for (int i = 0; i < count; i += batch)
+        made += sales_addBatch(batchedSales, batched, requests + i, 
+                (count - i < batch) ? count - i : batch, accepted);
+    double batchTime = benchmark_now() - start;
+    
+    // Check same sales were made and same stock is left
+    int match = (made == sales_count(singleSales)) 
+            && (made == sales_count(batchedSales));
+    for (int i = 0; match && (i < items); i++)
+        match = stockItem_getQuantity(inventory_getItem(single, i)) 
+                == stockItem_getQuantity(inventory_getItem(batched, i));
+    
+    printf("\nBENCHMARK: %d sales of %d stock items, %d sales made\n", 
+            count, items, made);
+    printf("%24s %10s\n", "Method", "Time");
+    printf("%24s %9.4fs\n", "sales_add", singleTime);
+    printf("%24s %9.4fs\n", "sales_addBatch", batchTime);
+    printf("%24s %10s\n", "check", match ? "results match" : "MISMATCH");
+    
+    sales_free(singleSales);
+    sales_free(batchedSales);
+    benchmark_freeInventory(single);
+    benchmark_freeInventory(batched);
+    for (int i = 0; i < items; i++)
+        free(IDs[i]);
+    free(IDs);
+    free(requests);
+    free(accepted);
+}
+
+/**
+ * Structure defining the work of a writer thread applying sales through a
+ * source of views.
+ */
+typedef struct BenchmarkFeedStruct {
+    InventoryViews *views;
+    const SaleRequest *requests;
+    int count;
+    atomic_int done;
+}
+BenchmarkFeed;
+
+/**
+ * Thread method applying every sale of a feed, then marking it done.
+ * 
+ * @param  Pointer to BenchmarkFeed of thread.
+ * @return Null.
+ */
+static void *benchmark_feed(void *argument) {
+    BenchmarkFeed *feed = (BenchmarkFeed*)argument;
+    
+    for (int i = 0; i < feed->count; i++)
+        inventoryViews_add(feed->views, feed->requests[i].date, 
+                feed->requests[i].ID, feed->requests[i].quantity);
+    atomic_store(&feed->done, 1);
+    
+    return NULL;
+}
+
+/**
+ * Method to time a writer thread applying a feed of sales, while this 
+ * thread pins views and runs Query 1 and a aggregate on each if a array 
+ * of views is given. The units sold in each view's sales records are 
+ * checked against the units taken from its stock items.
+ * 
+ * @param  Array of sales to be applied.
+ * @param  Integer number of sales.
+ * @param  Integer number of stock items to generate.
+ * @param  Array to store pinned views in, or null for no reader.
+ * @param  Integer maximum number of views kept.
+ * @param  Pointer to set to number of views pinned.
+ * @param  Pointer to set to total time spent pinning.
+ * @param  Pointer to set to 1 if every view's sales match its stock items
+ *         or 0 if not.
+ * @param  Pointer to set to source of views, of the generated inventory 
+ *         and its sales list, to be freed once kept views are released.
+ * @return Time taken by writer in seconds.
+ */
+static double benchmark_timeFeed(const SaleRequest *requests, int count, 
+        int items, InventoryView **kept, int keep, int *pinned, 
+        double *pinTime, int *consistent, InventoryViews **source) {
+    srand(2);
+    Inventory *inventory = benchmark_inventory(items);
+    
+    long long stocked = 0;
+    for (int i = 0; i < items; i++)
+        stocked += stockItem_getQuantity(inventory_getItem(inventory, i));
+    
+    InventoryViews *views = inventoryViews_new(inventory, sales_new());
+    BenchmarkFeed feed = { views, requests, count, 0 };
+    pthread_t writer;
+    
+    double start = benchmark_now();
+    if (pthread_create(&writer, NULL, benchmark_feed, &feed) != 0) {
+        fprintf(stderr, "Error: Unable to start thread in "
+                "benchmark_timeFeed().\n");
+        exit(EXIT_FAILURE);
+    }
+    
+    // Pin views while sales are applied, keeping the first for checking
+    *pinned     = 0;
+    *pinTime    = 0;
+    *consistent = 1;
+    while (kept && !atomic_load(&feed.done)) {
+        double pinStart = benchmark_now();
+        InventoryView *view = inventoryView_pin(views);
+        *pinTime += benchmark_now() - pinStart;
+        
+        Inventory *viewed = inventoryView_inventory(view);
+        inventory_sort(viewed);
+        int aggregate = inventory_registerAggregate(viewed, 
+                AGGREGATE_QUANTITY, aggregate_filter, &(AggregateFilter){ 
+                COMPONENT_TYPE_NONE, ATTRIBUTE_NONE, 0, 0 });
+        
+        // Read sales of view while writer keeps growing the sales list
+        const SalesRecord *records = inventoryView_sales(view);
+        long long sold = 0;
+        for (int s = 0; s < inventoryView_salesCount(view); s++)
+            sold += records[s].quantity;
+        *consistent &= inventory_getAggregate(viewed, aggregate) + sold 
+                == stocked;
+        
+        if (*pinned < keep)
+            kept[*pinned] = view;
+        else
+            inventoryView_release(view);
+        (*pinned)++;
+    }
+    pthread_join(writer, NULL);
+    double time = benchmark_now() - start;
+    
+    *source = views;
+    return time;
+}
+
+/**
+ * Method to free a source of views used by benchmark_timeFeed(), with its
+ * inventory and sales list, once all its views have been released.
+ * 
+ * @param Pointer to source of views to be freed.
+ */
+static void benchmark_freeFeed(InventoryViews *views) {
+    Inventory *inventory = views->inventory;
+    Sales *sales = views->sales;
+    
+    inventoryViews_free(views);
+    sales_free(sales);
+    benchmark_freeInventory(inventory);
+}
+
+/**
+ * Method to benchmark a writer thread applying sales while a reader pins
+ * consistent views and runs queries on them, growing the sales list as 
+ * it goes. Checks the quantities of every view kept are those left after 
+ * the sales in its records, and its aggregate matches them.
+ */
+static void benchmark_views() {
+    const int count = 2000000, items = 1000, keep = 64;
+    
+    SaleRequest *requests = (SaleRequest*)malloc(sizeof(SaleRequest) 
+            * count);
+    char **IDs = (char**)malloc(sizeof(char*) * items);
+    int *quantities = (int*)malloc(sizeof(int) * items);
+    InventoryView **kept = (InventoryView**)malloc(sizeof(InventoryView*) 
+            * keep);
+    // Null check memory allocation
+    if (!requests || !IDs || !quantities || !kept) {
+        fprintf(stderr, "Error: Unable to allocate memory in "
+                "benchmark_views().\n");
+        exit(EXIT_FAILURE);
+    }
+    srand(6);
+    for (int i = 0; i < items; i++) {
+        IDs[i] = (char*)malloc(sizeof(char) * BENCHMARK_ID_BUFFER);
+        snprintf(IDs[i], BENCHMARK_ID_BUFFER, "BENCH_%d", i);
+    }
+    for (int i = 0; i < count; i++)
+        requests[i] = (SaleRequest){ date_new(1 + rand() % 28, 
+                1 + rand() % 12, 1980 + rand() % 40), IDs[rand() % items], 
+                1 };
+    
+    // Time writer alone, then with a reader
+    InventoryViews *views;
+    int pinned, consistent;
+    double pinTime;
+    double alone = benchmark_timeFeed(requests, count, items, NULL, 0, 
+            &pinned, &pinTime, &consistent, &views);
+    benchmark_freeFeed(views);
+    double shared = benchmark_timeFeed(requests, count, items, kept, keep, 
+            &pinned, &pinTime, &consistent, &views);
+    
+    // Replay sales of each kept view onto starting quantities
+    srand(2);
+    Inventory *initial = benchmark_inventory(items);
+    for (int v = 0; v < ((pinned < keep) ? pinned : keep); v++) {
+        Inventory *viewed = inventoryView_inventory(kept[v]);
+        long long total = 0;
+        
+        for (int i = 0; i < items; i++)
+            quantities[i] = stockItem_getQuantity(
+                    inventory_getItem(initial, i));
+        const SalesRecord *records = inventoryView_sales(kept[v]);
+        for (int s = 0; s < inventoryView_salesCount(kept[v]); s++)
+            quantities[stockItem_getIndex(records[s].item)] 
+                    -= records[s].quantity;
+        
+        for (int i = 0; i < items; i++) {
+            StockItem *item = inventory_find(viewed, IDs[i]);
+            consistent &= stockItem_getQuantity(item) == quantities[i];
+            total += quantities[i];
+        }
+        consistent &= inventory_getAggregate(viewed, 0) == total;
+        inventoryView_release(kept[v]);
+    }
+    
+    printf("\nBENCHMARK: writer applying %d sales while views are pinned\n",
+            count);
+    printf("%26s %9.4fs\n", "writer alone", alone);
+    printf("%26s %9.4fs\n", "writer with reader", shared);
+    printf("%26s %10d\n", "views pinned", pinned);
+    printf("%26s %9.6fs\n", "mean time to pin", 
+            pinned ? pinTime / pinned : 0);
+    printf("%26s %10s\n", "check", consistent ? "views consistent" 
+            : "INCONSISTENT");
+    
+    benchmark_freeFeed(views);
+    benchmark_freeInventory(initial);
+    for (int i = 0; i < items; i++)
+        free(IDs[i]);
+    free(IDs);
+    free(requests);
+    free(quantities);
+    free(kept);
+}
+
+/**
+ * Arguments of a producer thread of the queue benchmark, making its share
+ * of a feed of sales either through a queue or under a shared lock.
+ */
+typedef struct BenchmarkProducerStruct {
+    SaleQueue *queue;
+    pthread_mutex_t *lock;
+    Inventory *inventory;
+    Sales *sales;
+    const SaleRequest *requests;
+    int count;
+    SaleCompletion *completions;
+}
+BenchmarkProducer;
+
+/**
+ * Thread method making every sale of a producer's share, pushing it to 
+ * the queue with a completion slot, or applying it with sales_add() under
+ * the shared lock if there is no queue.
+ * 
+ * @param  Pointer to BenchmarkProducer of thread.
+ * @return Null.
+ */
+static void *benchmark_produce(void *argument) {
+    BenchmarkProducer *producer = (BenchmarkProducer*)argument;
+    
+    for (int i = 0; i < producer->count; i++) {
+        const SaleRequest *request = &producer->requests[i];
+        if (producer->queue) {
+            saleCompletion_init(&producer->completions[i]);
+            saleQueue_push(producer->queue, request->date, request->ID, 
+                    request->quantity, &producer->completions[i]);
+        }
+        else {
+            pthread_mutex_lock(producer->lock);
+            sales_add(producer->sales, producer->inventory, request->date, 
+                    (char*)request->ID, request->quantity);
+            pthread_mutex_unlock(producer->lock);
+        }
+    }
+    
+    return NULL;
+}
+
+/**
+ * Method to time producer threads splitting a feed of sales between them,
+ * through a queue or under a shared lock, on a generated inventory. When
+ * queued, checks the accepted completions match the sales made and the 
+ * quantities left match the starting quantities less the sales list.
+ * 
+ * @param  Array of sales to be made.
+ * @param  Integer number of sales.
+ * @param  Integer number of stock items to generate.
+ * @param  Integer number of producer threads.
+ * @param  Integer 1 to use a queue or 0 to use a lock.
+ * @param  Pointer to set to 1 if checks pass or 0 if not.
+ * @return Time taken in seconds.
+ */
+static double benchmark_timeProducers(const SaleRequest *requests, 
+        int count, int items, int threads, int queued, int *match) {
+    srand(2);
+    Inventory *inventory = benchmark_inventory(items);
+    Sales *sales = sales_new();
+    sales_reserve(sales, count);
+    int *quantities = (int*)malloc(sizeof(int) * items);
+    SaleCompletion *completions = (SaleCompletion*)malloc(
+            sizeof(SaleCompletion) * count);
+    BenchmarkProducer *producers = (BenchmarkProducer*)malloc(
+            sizeof(BenchmarkProducer) * threads);
+    pthread_t *workers = (pthread_t*)malloc(sizeof(pthread_t) * threads);
+    // Null check memory allocation
+    if (!quantities || !completions || !producers || !workers) {
+        fprintf(stderr, "Error: Unable to allocate memory in "
+                "benchmark_timeProducers().\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < items; i++)
+        quantities[i] = stockItem_getQuantity(inventory_getItem(inventory, 
+                i));
+    
+    pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+    double start = benchmark_now();
+    SaleQueue *queue = queued ? saleQueue_new(SALE_QUEUE_BATCH * 4, 
+            inventory, sales) : NULL;
+    for (int i = 0; i < threads; i++) {
+        int first = (int)((long)count * i / threads);
+        int last  = (int)((long)count * (i + 1) / threads);
+        producers[i] = (BenchmarkProducer){ queue, &lock, inventory, sales,
+                requests + first, last - first, completions + first };
+        if (pthread_create(&workers[i], NULL, benchmark_produce, 
+                &producers[i]) != 0) {
+            fprintf(stderr, "Error: Unable to start thread in "
+                    "benchmark_timeProducers().\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    for (int i = 0; i < threads; i++)
+        pthread_join(workers[i], NULL);
+    if (queue)
+        saleQueue_free(queue);
+    double time = benchmark_now() - start;
+    
+    // Check completions and stock left against sales list
+    *match = 1;
+    if (queued) {
+        int accepted = 0;
+        for (int i = 0; i < count; i++)
+            accepted += saleCompletion_wait(&completions[i]) 
+                    == SALE_ACCEPTED;
+        *match = accepted == sales_count(sales);
+        
+        SalesIterator sale = sales_first(sales);
+        for (int s = 0; s < sales_count(sales); s++, sale++)
+            quantities[stockItem_getIndex(sale->item)] -= sale->quantity;
+        for (int i = 0; *match && (i < items); i++)
+            *match = stockItem_getQuantity(inventory_getItem(inventory, i)) 
+                    == quantities[i];
+    }
+    
+    sales_free(sales);
+    benchmark_freeInventory(inventory);
+    free(quantities);
+    free(completions);
+    free(producers);
+    free(workers);
+    
+    return time;
+}
+
+/**
+ * Method to benchmark throughput of 1 to 4 producer threads making 
+ * generated sales through a queue applied by a single applier thread, 
+ * against each calling sales_add() under a shared lock. Checks the queue
+ * completions and stock left agree with the sales made.
+ */
+static void benchmark_queue() {
+    const int count = 2000000, items = 1000;
+    
+    SaleRequest *requests = (SaleRequest*)malloc(sizeof(SaleRequest) 
+            * count);
+    char **IDs = (char**)malloc(sizeof(char*) * items);
+    // Null check memory allocation
+    if (!requests || !IDs) {
+        fprintf(stderr, "Error: Unable to allocate memory in "
+                "benchmark_queue().\n");
+        exit(EXIT_FAILURE);
+    }
+    srand(7);
+    for (int i = 0; i < items; i++) {
+        IDs[i] = (char*)malloc(sizeof(char) * BENCHMARK_ID_BUFFER);
+        snprintf(IDs[i], BENCHMARK_ID_BUFFER, "BENCH_%d", i);
+    }
+    for (int i = 0; i < count; i++)
+        requests[i] = (SaleRequest){ date_new(1 + rand() % 28, 
+                1 + rand() % 12, 1980 + rand() % 40), IDs[rand() % items], 
+                1 + rand() % 5 };
+    
+    printf("\nBENCHMARK: %d sales of %d stock items from producer "
+            "threads\n", count, items);
+    printf("%10s %18s %18s %10s\n", "Producers", "Lock (sales/s)", 
+            "Queue (sales/s)", "Check");
+    
+    for (int threads = 1; threads <= 4; threads *= 2) {
+        int match;
+        double locked = benchmark_timeProducers(requests, count, items, 
+                threads, 0, &match);
+        double queued = benchmark_timeProducers(requests, count, items, 
+                threads, 1, &match);
+        printf("%10d %18.0f %18.0f %10s\n", threads, count / locked, 
+                count / queued, match ? "match" : "MISMATCH");
+    }
+    
+    for (int i = 0; i < items; i++)
+        free(IDs[i]);
+    free(IDs);
+    free(requests);
+}
+
+/**
+ * Method to benchmark creating stock items with their ID and description
+ * strings using a malloc for each, as the loader once did, against taking
+ * them from the inventory's arena, then freeing the inventory and items.
+ */
+static void benchmark_arena() {
+    const int items = 500000;
+    static char *types[] = { "resistor", "capacitor", "diode", 
+            "transistor", "IC" };
+    char ID[BENCHMARK_ID_BUFFER];
+    
+    // Allocate each stock item and its strings on their own
+    Inventory *single = inventory_new();
+    double start = benchmark_now();
+    for (int i = 0; i < items; i++) {
+        size_t length = snprintf(ID, BENCHMARK_ID_BUFFER, "BENCH_%d", i);
+        char *strings = (char*)malloc(length + 1);
+        // Null check memory allocation
+        if (!strings) {
+            fprintf(stderr, "Error: Unable to allocate memory in "
+                    "benchmark_arena().\n");
+            exit(EXIT_FAILURE);
+        }
+        memcpy(strings, ID, length + 1);
+        inventory_add(single, stockItem_new(types[i % 5], strings, 100, 1, 
+                NULL));
+    }
+    double singleTime = benchmark_now() - start;
+    start = benchmark_now();
+    for (int i = 0; i < items; i++) {
+        StockItem *item = inventory_getItem(single, i);
+        free(stockItem_getID(item));
+        stockItem_free(item);
+    }
+    inventory_free(single);
+    double singleFree = benchmark_now() - start;
+    
+    // Allocate each stock item and its strings from the arena in one piece
+    Inventory *arena = inventory_new();
+    start = benchmark_now();
+    for (int i = 0; i < items; i++) {
+        size_t length = snprintf(ID, BENCHMARK_ID_BUFFER, "BENCH_%d", i);
+        char *memory = (char*)arena_alloc(inventory_getArena(arena), 
+                sizeof(StockItem) + length + 1);
+        memcpy(memory + sizeof(StockItem), ID, length + 1);
+        inventory_add(arena, stockItem_init((StockItem*)memory, types[i % 5],
+                memory + sizeof(StockItem), 100, 1, NULL));
+    }
+    double arenaTime = benchmark_now() - start;
+    int blocks = inventory_getArena(arena)->blockCount;
+    size_t bytes = inventory_getArena(arena)->allocated;
+    start = benchmark_now();
+    inventory_free(arena);
+    double arenaFree = benchmark_now() - start;
+    
+    printf("\nBENCHMARK: creating and freeing %d stock items\n", items);
+    printf("%18s %10s %10s %14s\n", "Allocator", "Create", "Free", 
+            "Allocations");
+    printf("%18s %9.4fs %9.4fs %14d\n", "malloc per item", singleTime, 
+            singleFree, items * 2);
+    printf("%18s %9.4fs %9.4fs %14d\n", "inventory arena", arenaTime, 
+            arenaFree, blocks);
+    printf("%18s %10.1f\n", "arena bytes/item", (double)bytes / items);
+}
+
+/**
+ * Method to benchmark churn of inventory sized nodes, taking and releasing
+ * them in random order through malloc and through a pool, then churning a
+ * inventory by moving stock items from its head to its tail and printing
+ * the occupancy of its node slabs.
+ */
+static void benchmark_pool() {
+    const int live = 100000, operations = 10000000, items = 10000;
+    
+    void **objects = (void**)malloc(sizeof(void*) * live);
+    // Null check memory allocation
+    if (!objects) {
+        fprintf(stderr, "Error: Unable to allocate memory in "
+                "benchmark_pool().\n");
+        exit(EXIT_FAILURE);
+    }
+    
+    // Replace a random live node each operation with malloc
+    srand(8);
+    for (int i = 0; i < live; i++)
+        objects[i] = malloc(sizeof(InventoryNode));
+    double start = benchmark_now();
+    for (int i = 0; i < operations; i++) {
+        int slot = rand() % live;
+        free(objects[slot]);
+        objects[slot] = malloc(sizeof(InventoryNode));
+    }
+    double mallocTime = benchmark_now() - start;
+    for (int i = 0; i < live; i++)
+        free(objects[i]);
+    
+    // And with a pool
+    srand(8);
+    Pool pool;
+    pool_init(&pool, sizeof(InventoryNode));
+    for (int i = 0; i < live; i++)
+        objects[i] = pool_alloc(&pool);
+    start = benchmark_now();
+    for (int i = 0; i < operations; i++) {
+        int slot = rand() % live;
+        pool_release(&pool, objects[slot]);
+        objects[slot] = pool_alloc(&pool);
+    }
+    double poolTime = benchmark_now() - start;
+    pool_free(&pool);
+    free(objects);
+    
+    // Move stock items from head to tail of a inventory
+    srand(2);
+    Inventory *inventory = benchmark_inventory(items);
+    start = benchmark_now();
+    for (int i = 0; i < operations / 10; i++)
+        inventory_add(inventory, inventory_removeHead(inventory));
+    double churnTime = benchmark_now() - start;
+    PoolStats stats;
+    inventory_getNodeStats(inventory, &stats);
+    benchmark_freeInventory(inventory);
+    
+    printf("\nBENCHMARK: %d node replacements among %d live nodes\n", 
+            operations, live);
+    printf("%26s %9.4fs\n", "malloc and free", mallocTime);
+    printf("%26s %9.4fs\n", "pool", poolTime);
+    printf("%26s %9.4fs\n", "inventory head to tail", churnTime);
+    printf("%26s %10d\n", "node slabs", stats.slabs);
+    printf("%26s %10ld\n", "nodes live", stats.live);
+    printf("%26s %10ld\n", "nodes peak", stats.peak);
+    printf("%26s %9.1f%%\n", "slab occupancy", stats.occupancy * 100);
+}
+
+/**
+ * Method to write sales with one printf per record, the way sales were 
+ * printed before the report writer, used as its baseline.
+ * 
+ * @param File to write to.
+ * @param Pointer to sales list to be written.
+ */
+static void benchmark_printSales(FILE *file, const Sales *sales) {
+    char date[DATE_BUFFER], price[MONEY_BUFFER], cost[MONEY_BUFFER];
+    SalesIterator sale = sales_first(sales);
+    
+    for (int i = 0; i < sales_count(sales); i++, sale++)
+        fprintf(file, "\nDate:           %s\n"
+                "ID:             %s\n"
+                "Quantity:       %d\n"
+                "Price per item: £%s\n"
+                "Cost of Sale:   £%s\n",
+                date_format(sale->date, date), sales_getID(sale), 
+                sales_getQuantity(sale), 
+                money_format(stockItem_getPennies(sale->item), price),
+                money_format(sales_getTotal(sale), cost));
+}
+
+/**
+ * Method to check two files hold the same bytes.
+ * 
+ * @param  File name of first file.
+ * @param  File name of second file.
+ * @return 1 if files match or 0 if not.
+ */
+static int benchmark_sameFiles(const char *first, const char *second) {
+    MappedFile a, b;
+    mappedFile_open(&a, first);
+    mappedFile_open(&b, second);
+    
+    int match = (a.size == b.size) 
+            && ((a.size == 0) || (memcmp(a.data, b.data, a.size) == 0));
+    
+    mappedFile_close(&a);
+    mappedFile_close(&b);
+    return match;
+}
+
+/**
+ * Method to benchmark writing a large sales list to a file with one 
+ * printf per record against the report writer, checking both write the 
+ * same bytes.
+ */
+static void benchmark_report() {
+    const int count = 1000000, items = 1000;
+    const char *printed = "benchmark_printf.txt";
+    const char *reported = "benchmark_report.txt";
+    
+    srand(9);
+    Inventory *inventory = benchmark_inventory(items);
+    Sales *sales = sales_new();
+    sales_reserve(sales, count);
+    for (int i = 0; i < count; i++)
+        sales_append(sales, inventory_getItem(inventory, rand() % items), 
+                date_new(1 + rand() % 28, 1 + rand() % 12, 
+                1980 + rand() % 40), 1 + rand() % 5);
+    
+    // Write with printf
+    double start = benchmark_now();
+    FILE *file = fopen(printed, "w");
+    if (!file) {
+        fprintf(stderr, "Error: Unable to open '%s' in mode 'w' "
+                "in benchmark_report().\n", printed);
+        exit(EXIT_FAILURE);
+    }
+    benchmark_printSales(file, sales);
+    fclose(file);
+    double printfTime = benchmark_now() - start;
+    
+    // Write with report writer
+    start = benchmark_now();
+    int descriptor = open(reported, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (descriptor < 0) {
+        fprintf(stderr, "Error: Unable to open '%s' for writing "
+                "in benchmark_report().\n", reported);
+        exit(EXIT_FAILURE);
+    }
+    static Report report;
+    report_init(&report, descriptor);
+    sales_write(&report, sales);
+    report_flush(&report);
+    close(descriptor);
+    double reportTime = benchmark_now() - start;
+    
+    int match = benchmark_sameFiles(printed, reported);
+    
+    printf("\nBENCHMARK: writing %d sales to a file\n", count);
+    printf("%18s %10s %14s\n", "Writer", "Time", "Rows/s");
+    printf("%18s %9.4fs %14.0f\n", "printf per row", printfTime, 
+            count / printfTime);
+    printf("%18s %9.4fs %14.0f\n", "report writer", reportTime, 
+            count / reportTime);
+    printf("%18s %10s\n", "check", match ? "output matches" : "MISMATCH");
+    
+    remove(printed);
+    remove(reported);
+    sales_free(sales);
+    benchmark_freeInventory(inventory);
+}
+
+/**
+ * Table of all benchmarks by name.
+ */
+static const struct {
+    const char *name;
+    void (*run)();
+} BENCHMARKS[] = {
+    { "sort", benchmark_sort },
+    { "load", benchmark_load },
+    { "parallel", benchmark_parallel },
+    { "range", benchmark_range },
+    { "rollup", benchmark_rollup },
+    { "topsellers", benchmark_topsellers },
+    { "contention", benchmark_contention },
+    { "sharded", benchmark_sharded },
+    { "batch", benchmark_batch },
+    { "views", benchmark_views },
+    { "queue", benchmark_queue },
+    { "arena", benchmark_arena },
+    { "pool", benchmark_pool },
+    { "report", benchmark_report }
+};
+
+/**
+ * Method to run the benchmark with the given name, or all benchmarks if
+ * name is null, printing timings to the console.
+ * 
+ * @param  Char name of benchmark to run, or null to run all.
+ * @return 1 if a benchmark was run or 0 if name is unknown.
+ */
+int benchmark_run(const char *name) {
+    int run = 0;
+    
+    for (size_t i = 0; i < sizeof(BENCHMARKS) / sizeof(BENCHMARKS[0]); i++)
+        if (!name || (strcmp(name, BENCHMARKS[i].name) == 0)) {
+            BENCHMARKS[i].run();
+            run = 1;
+        }
+    
+    return run;
+}
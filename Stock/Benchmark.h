@@ -0,0 +1,27 @@
+/* 
+ * File:   Benchmark.h
+ * Author: Paulo Jorge
+ */
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Method to run the benchmark with the given name, or all benchmarks if
+ * name is null, printing timings to the console.
+ * 
+ * @param  Char name of benchmark to run, or null to run all.
+ * @return 1 if a benchmark was run or 0 if name is unknown.
+ */
+int benchmark_run(const char *name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BENCHMARK_H */
+
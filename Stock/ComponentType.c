@@ -0,0 +1,109 @@
+/* 
+ * File:   ComponentType.c
+ * Author: Paulo Jorge
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "ComponentType.h"
+
+// Maximum number of distinct types, as type codes are stored in a byte
+#define COMPONENT_TYPE_MAX 256
+
+// Interned type names, indexed by type code. Names are published by 
+// storing the count after them, so lookups need no lock, while inserts are
+// serialised by the mutex
+static char *componentTypeNames[COMPONENT_TYPE_MAX];
+static atomic_int componentTypeCount = 0;
+static pthread_mutex_t componentTypeLock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * Method to intern a component type name, such as "resistor", returning 
+ * its small integer type code. Each distinct name is stored only once and 
+ * keeps the same code for the life of the program. Safe to call from 
+ * several threads at once. Or generates error message if there are too 
+ * many types or memory allocation fails and terminates program.
+ * 
+ * @param  Char type name.
+ * @return Integer type code.
+ */
+int componentType_intern(const char *name) {
+    int code = componentType_find(name);
+    if (code != COMPONENT_TYPE_NONE)
+        return code;
+    
+    // Look again under lock, as another thread may have just added name
+    pthread_mutex_lock(&componentTypeLock);
+    code = componentType_find(name);
+    if (code != COMPONENT_TYPE_NONE) {
+        pthread_mutex_unlock(&componentTypeLock);
+        return code;
+    }
+    
+    // Output error and exit if type codes would no longer fit a byte
+    code = atomic_load_explicit(&componentTypeCount, memory_order_relaxed);
+    if (code == COMPONENT_TYPE_MAX) {
+        fprintf(stderr, "Error: Too many component types in "
+                "componentType_intern().\n");
+        exit(EXIT_FAILURE);
+    }
+    
+    // Store a copy of name sized to fit
+    char *copy = (char*)malloc(sizeof(char) * (strlen(name) + 1));
+    // Null check memory allocation
+    if (!copy) {
+        fprintf(stderr, "Error: Unable to allocate memory in "
+                "componentType_intern().\n");
+        exit(EXIT_FAILURE);
+    }
+    strcpy(copy, name);
+    componentTypeNames[code] = copy;
+    
+    // Publish name only once it is stored
+    atomic_store_explicit(&componentTypeCount, code + 1, 
+            memory_order_release);
+    pthread_mutex_unlock(&componentTypeLock);
+    
+    return code;
+}
+
+/**
+ * Method to find the type code of a component type name without interning
+ * it, used to resolve a type once before filtering on it.
+ * 
+ * @param  Char type name.
+ * @return Integer type code or COMPONENT_TYPE_NONE if name is unknown.
+ */
+int componentType_find(const char *name) {
+    // Few distinct types exist so a linear scan is fastest
+    int count = atomic_load_explicit(&componentTypeCount, 
+            memory_order_acquire);
+    for (int code = 0; code < count; code++)
+        if (strcmp(componentTypeNames[code], name) == 0)
+            return code;
+    
+    return COMPONENT_TYPE_NONE;
+}
+
+/**
+ * Get method to get the name of a component type code.
+ * 
+ * @param  Integer type code.
+ * @return Type name char.
+ */
+const char *componentType_getName(int code) {
+    return componentTypeNames[code];
+}
+
+/**
+ * Method to return the number of component types interned so far.
+ * 
+ * @return Integer number of types, codes run from 0 to count - 1.
+ */
+int componentType_count() {
+    return atomic_load_explicit(&componentTypeCount, memory_order_acquire);
+}
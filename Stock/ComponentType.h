@@ -0,0 +1,59 @@
+/* 
+ * File:   ComponentType.h
+ * Author: Paulo Jorge
+ */
+
+#ifndef COMPONENTTYPE_H
+#define COMPONENTTYPE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Type code returned when a type name has not been interned.
+ */
+#define COMPONENT_TYPE_NONE (-1)
+
+/**
+ * Method to intern a component type name, such as "resistor", returning 
+ * its small integer type code. Each distinct name is stored only once and 
+ * keeps the same code for the life of the program. Safe to call from 
+ * several threads at once. Or generates error message if there are too 
+ * many types or memory allocation fails and terminates program.
+ * 
+ * @param  Char type name.
+ * @return Integer type code.
+ */
+int componentType_intern(const char *name);
+
+/**
+ * Method to find the type code of a component type name without interning
+ * it, used to resolve a type once before filtering on it.
+ * 
+ * @param  Char type name.
+ * @return Integer type code or COMPONENT_TYPE_NONE if name is unknown.
+ */
+int componentType_find(const char *name);
+
+/**
+ * Get method to get the name of a component type code.
+ * 
+ * @param  Integer type code.
+ * @return Type name char.
+ */
+const char *componentType_getName(int code);
+
+/**
+ * Method to return the number of component types interned so far.
+ * 
+ * @return Integer number of types, codes run from 0 to count - 1.
+ */
+int componentType_count();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* COMPONENTTYPE_H */
+
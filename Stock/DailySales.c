@@ -0,0 +1,199 @@
+/* 
+ * File:   DailySales.c
+ * Author: Paulo Jorge
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "DailySales.h"
+#include "StockItem.h"
+#include "Ranking.h"
+
+// Number of days allocated for the first sale added
+#define DAILY_SALES_MIN_CAPACITY 64
+
+/**
+ * Method to allocate memory for a new empty set of daily totals. Or
+ * generates error message if memory allocation fails and terminates
+ * program.
+ * 
+ * @return Pointer to newly created daily totals.
+ */
+DailySales *dailySales_new() {
+    // Allocate daily totals to memory
+    DailySales *daily = (DailySales*)malloc(sizeof(DailySales));
+    // Null check memory allocation
+    if (!daily) {
+        fprintf(stderr, "Error: Unable to allocate memory in "
+                "dailySales_new().\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // As empty, no days are covered
+    daily->first    = DATE_NONE;
+    daily->days     = 0;
+    daily->capacity = 0;
+    daily->revenue  = NULL;
+    daily->units    = NULL;
+
+    return daily;
+}
+
+/**
+ * Method to grow daily totals to cover a date, keeping existing totals.
+ * Or generates error message if memory allocation fails and terminates
+ * program.
+ * 
+ * @param  Pointer to daily totals to be grown.
+ * @param  Date to be covered.
+ * @return Integer index of date within the totals.
+ */
+static int dailySales_cover(DailySales *daily, Date date) {
+    // First sale starts the range at its own date
+    if (daily->days == 0)
+        daily->first = date;
+
+    int index = date_difference(daily->first, date);
+    if ((index >= 0) && (index < daily->days))
+        return index;
+
+    // Days that must be added before and after the current range
+    int before = (index < 0) ? -index : 0;
+    int days = (index < 0) ? daily->days + before : index + 1;
+
+    // Double capacity so sales spread over time grow in few steps
+    if (days > daily->capacity) {
+        int capacity = daily->capacity ? daily->capacity
+                : DAILY_SALES_MIN_CAPACITY;
+        while (capacity < days)
+            capacity *= 2;
+
+        daily->revenue = (Money*)realloc(daily->revenue,
+                sizeof(Money) * capacity);
+        daily->units = (long long*)realloc(daily->units,
+                sizeof(long long) * capacity);
+        // Null check memory allocation
+        if (!daily->revenue || !daily->units) {
+            fprintf(stderr, "Error: Unable to allocate memory in "
+                    "dailySales_cover().\n");
+            exit(EXIT_FAILURE);
+        }
+        daily->capacity = capacity;
+    }
+
+    // Move existing totals up when range starts earlier
+    if (before > 0) {
+        memmove(daily->revenue + before, daily->revenue,
+                sizeof(Money) * daily->days);
+        memmove(daily->units + before, daily->units,
+                sizeof(long long) * daily->days);
+        memset(daily->revenue, 0, sizeof(Money) * before);
+        memset(daily->units, 0, sizeof(long long) * before);
+        daily->first = date;
+        index = 0;
+    } else {
+        memset(daily->revenue + daily->days, 0,
+                sizeof(Money) * (days - daily->days));
+        memset(daily->units + daily->days, 0,
+                sizeof(long long) * (days - daily->days));
+    }
+    daily->days = days;
+
+    return index;
+}
+
+/**
+ * Method to add a sale to the total of its day. Or generates error message
+ * if memory allocation fails and terminates program.
+ * 
+ * @param Pointer to daily totals to be added to.
+ * @param Pointer to sales record to be added.
+ */
+void dailySales_add(DailySales *daily, const SalesRecord *record) {
+    int index = dailySales_cover(daily, record->date);
+
+    daily->revenue[index] += sales_getTotal(record);
+    daily->units[index]   += record->quantity;
+}
+
+/**
+ * Method to add every sale in a sales list to the totals of their days, in
+ * a single pass. Or generates error message if memory allocation fails and
+ * terminates program.
+ * 
+ * @param Pointer to daily totals to be added to.
+ * @param Pointer to sales list to be added.
+ */
+void dailySales_addSales(DailySales *daily, const Sales *sales) {
+    for (int i = 0; i < sales->count; i++)
+        dailySales_add(daily, &sales->records[i]);
+}
+
+/**
+ * Method to get the totals of a single day.
+ * 
+ * @param  Pointer to daily totals to be checked.
+ * @param  Date of day.
+ * @return Totals of day, zero if no sales were made on it.
+ */
+DailyTotal dailySales_get(const DailySales *daily, Date date) {
+    DailyTotal total = { date, 0, 0 };
+    int index = date_difference(daily->first, date);
+
+    if ((daily->days > 0) && (index >= 0) && (index < daily->days)) {
+        total.revenue = daily->revenue[index];
+        total.units   = daily->units[index];
+    }
+    return total;
+}
+
+/**
+ * Method to find the days with the highest totals of a measure. Days
+ * without sales are never returned and days with equal totals are ranked
+ * oldest first.
+ * 
+ * @param  Pointer to daily totals to be checked.
+ * @param  Measure days are ranked on.
+ * @param  Integer maximum number of days to find.
+ * @param  Array of at least count totals where days will be stored,
+ *         highest first.
+ * @return Integer number of days found.
+ */
+int dailySales_top(const DailySales *daily, DailySalesMeasure measure,
+        int count, DailyTotal *top) {
+    if ((count <= 0) || (daily->days == 0))
+        return 0;
+
+    // Rank days by index, which orders days with equal totals oldest first
+    RankingEntry *heap = ranking_new((count < daily->days) ? count
+            : daily->days);
+    int found = 0;
+    for (int i = 0; i < daily->days; i++)
+        if (daily->units[i] != 0)
+            found = ranking_offer(heap, found, count,
+                    (measure == DAILY_SALES_REVENUE) ? daily->revenue[i]
+                        : daily->units[i], i);
+    ranking_sort(heap, found);
+
+    for (int i = 0; i < found; i++) {
+        int day = heap[i].index;
+        top[i] = (DailyTotal){ daily->first + day, daily->revenue[day],
+                daily->units[day] };
+    }
+
+    free(heap);
+    return found;
+}
+
+/**
+ * Method to free daily totals from memory.
+ * 
+ * @param Pointer to daily totals to which will be freed from memory.
+ */
+void dailySales_free(DailySales *daily) {
+    free(daily->revenue);
+    free(daily->units);
+    free(daily);
+}
@@ -0,0 +1,114 @@
+/* 
+ * File:   DailySales.h
+ * Author: Paulo Jorge
+ */
+
+#ifndef DAILYSALES_H
+#define DAILYSALES_H
+
+#include "Date.h"
+#include "Sales.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Measures days can be ranked on.
+ */
+typedef enum DailySalesMeasureEnum {
+    // Total revenue in pennies
+    DAILY_SALES_REVENUE,
+    // Total number of units sold
+    DAILY_SALES_UNITS
+}
+DailySalesMeasure;
+
+/**
+ * Structure holding the totals of all sales made on one day.
+ */
+typedef struct DailyTotalStruct {
+    Date date;
+    Money revenue;
+    long long units;
+}
+DailyTotal;
+
+/**
+ * Structure grouping sales by day. Totals are held in dense arrays indexed
+ * by days since the first date, which grow in either direction as sales
+ * outside the current range are added, so sales may be in any order.
+ */
+typedef struct DailySalesStruct {
+    Date first;
+    int days, capacity;
+    Money *revenue;
+    long long *units;
+}
+DailySales;
+
+/**
+ * Method to allocate memory for a new empty set of daily totals. Or
+ * generates error message if memory allocation fails and terminates
+ * program.
+ * 
+ * @return Pointer to newly created daily totals.
+ */
+DailySales *dailySales_new();
+
+/**
+ * Method to add a sale to the total of its day. Or generates error message
+ * if memory allocation fails and terminates program.
+ * 
+ * @param Pointer to daily totals to be added to.
+ * @param Pointer to sales record to be added.
+ */
+void dailySales_add(DailySales *daily, const SalesRecord *record);
+
+/**
+ * Method to add every sale in a sales list to the totals of their days, in
+ * a single pass. Or generates error message if memory allocation fails and
+ * terminates program.
+ * 
+ * @param Pointer to daily totals to be added to.
+ * @param Pointer to sales list to be added.
+ */
+void dailySales_addSales(DailySales *daily, const Sales *sales);
+
+/**
+ * Method to get the totals of a single day.
+ * 
+ * @param  Pointer to daily totals to be checked.
+ * @param  Date of day.
+ * @return Totals of day, zero if no sales were made on it.
+ */
+DailyTotal dailySales_get(const DailySales *daily, Date date);
+
+/**
+ * Method to find the days with the highest totals of a measure. Days
+ * without sales are never returned and days with equal totals are ranked
+ * oldest first.
+ * 
+ * @param  Pointer to daily totals to be checked.
+ * @param  Measure days are ranked on.
+ * @param  Integer maximum number of days to find.
+ * @param  Array of at least count totals where days will be stored,
+ *         highest first.
+ * @return Integer number of days found.
+ */
+int dailySales_top(const DailySales *daily, DailySalesMeasure measure,
+        int count, DailyTotal *top);
+
+/**
+ * Method to free daily totals from memory.
+ * 
+ * @param Pointer to daily totals to which will be freed from memory.
+ */
+void dailySales_free(DailySales *daily);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DAILYSALES_H */
+
@@ -5,41 +5,71 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <unistd.h>
 
 #include "Date.h"
+#include "Report.h"
 
-// Buffer size for date (Date length (10) + null terminator (1))
-const int SALES_DATE_BUFFER = 11;
+// Days before the first of each month in a common year, by month number
+static const int DATE_DAYS_BEFORE_MONTH[13] =
+        { 0, 0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334 };
+
+// Days in each month in a common year, by month number
+static const int DATE_DAYS_IN_MONTH[13] =
+        { 0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+
+// Days in each 400 year cycle, and offset from day ordinals to days
+// counted from 01/03/0000
+#define DATE_DAYS_PER_ERA 146097
+#define DATE_MARCH_OFFSET 305
+
+/**
+ * Method to check if a year is a leap year.
+ * 
+ * @param  Full year integer value.
+ * @return 1 if year is a leap year or 0 if not.
+ */
+static inline int date_isLeapYear(int year) {
+    return ((year % 4) == 0) && (((year % 100) != 0) || ((year % 400) == 0));
+}
 
 /**
- * Method to allocate memory for a new date containing information 
- * about itself. Or generates error message if memory allocation fails
- * and terminates program.
+ * Method to create a date from its day, month and year if it is valid.
  * 
- * @param  Day integer, such as 9.
- * @param  Month integer, such as 10.
+ * @param  Day integer, such as 9 without leading 0's.
+ * @param  Month integer, such as 10 without leading 0's.
  * @param  Full year integer value, such as 2017.
- * @return Pointer to newly created date type.
+ * @return Date value, or DATE_NONE if date is not valid.
  */
-Date* date_new(int day, int month, int year) {
-    // Allocate date to memory
-    Date *date = (Date*)malloc(sizeof(Date));
-    // Null check memory allocation
-    if (!date) {
-        fprintf(stderr, "Error: Unable to allocate memory in "
-                "date_new().\n");
-        exit(EXIT_FAILURE);
-    }
-    
+Date date_fromDMY(int day, int month, int year) {
     // Ensure that date is valid
-    if ((day > 0) && (day <= 31) 
-            && (month > 0) && (month <= 12)  
-            && (year >= 1000) && (year <= 9999)) {
-        date->day   = day;
-        date->month = month;
-        date->year  = year;
-    // Else output error and exit program
-    } else {
+    if ((month < 1) || (month > 12) || (year < 1000) || (year > 9999))
+        return DATE_NONE;
+    int leap = date_isLeapYear(year);
+    if ((day < 1) || (day > DATE_DAYS_IN_MONTH[month]
+            + ((month == 2) & leap)))
+        return DATE_NONE;
+
+    // Count days in all previous years, then in this year
+    int previous = year - 1;
+    return 365 * previous + previous / 4 - previous / 100 + previous / 400
+            + DATE_DAYS_BEFORE_MONTH[month] + ((month > 2) & leap) + day;
+}
+
+/**
+ * Method to create a date from its day, month and year. Or generates error
+ * message if date is not valid and terminates program.
+ * 
+ * @param  Day integer, such as 9 without leading 0's.
+ * @param  Month integer, such as 10 without leading 0's.
+ * @param  Full year integer value, such as 2017.
+ * @return Date value.
+ */
+Date date_new(int day, int month, int year) {
+    Date date = date_fromDMY(day, month, year);
+
+    // Output error and exit program if date is not valid
+    if (date == DATE_NONE) {
         fprintf(stderr, "Error: Date provided is not valid "
                 "in date_new().\n");
         exit(EXIT_FAILURE);
@@ -48,83 +78,133 @@ Date* date_new(int day, int month, int year) {
 }
 
 /**
- * Method to compare two dates and return the result of which one is newer. 
+ * Method to parse a date in the fixed form "DD/MM/YYYY". The text does
+ * not need to be null terminated but must contain at least 10 chars.
  * 
- * @param  Pointer to date to compare against.
- * @param  Pointer to second date to compare against the first date.
- * @return Returns 0 if date 1 is newer than date 2 or 1 if older.
+ * @param  Pointer to first of 10 chars of date.
+ * @return Date value, or DATE_NONE if text is not a valid date in this
+ *         form.
  */
-int date_compare(const Date* date1, const Date* date2) {
-    // Compare dates
-    if (date_getYear(date1) > date_getYear(date2))
-        return 0;
-    else if (date_getMonth(date1) > date_getMonth(date2))
-        return 0;
-    else if (date_getDay(date1) > date_getDay(date2))
-        return 0;
-    return 1;
+Date date_parse(const char *text) {
+    // Convert each digit position, any char that is not a digit gives a
+    // value above 9
+    unsigned d0 = (unsigned char)text[0] - '0';
+    unsigned d1 = (unsigned char)text[1] - '0';
+    unsigned m0 = (unsigned char)text[3] - '0';
+    unsigned m1 = (unsigned char)text[4] - '0';
+    unsigned y0 = (unsigned char)text[6] - '0';
+    unsigned y1 = (unsigned char)text[7] - '0';
+    unsigned y2 = (unsigned char)text[8] - '0';
+    unsigned y3 = (unsigned char)text[9] - '0';
+
+    // Check all digits and separators together
+    if ((d0 > 9) | (d1 > 9) | (m0 > 9) | (m1 > 9) | (y0 > 9) | (y1 > 9) 
+            | (y2 > 9) | (y3 > 9) | (text[2] != '/') | (text[5] != '/'))
+        return DATE_NONE;
+
+    return date_fromDMY(d0 * 10 + d1, m0 * 10 + m1,
+            y0 * 1000 + y1 * 100 + y2 * 10 + y3);
+}
+
+/**
+ * Method to split a date into its day, month and year.
+ * 
+ * @param Date to be split.
+ * @param Pointer to where day will be stored.
+ * @param Pointer to where month will be stored.
+ * @param Pointer to where year will be stored.
+ */
+static void date_split(Date date, int *day, int *month, int *year) {
+    // Count days from 01/03/0000 so leap days fall at the end of each year
+    int days = date + DATE_MARCH_OFFSET;
+    int era = days / DATE_DAYS_PER_ERA;
+    int dayOfEra = days - era * DATE_DAYS_PER_ERA;
+    int yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524
+            - dayOfEra / 146096) / 365;
+    int dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4
+            - yearOfEra / 100);
+    // Months counted from March
+    int shiftedMonth = (5 * dayOfYear + 2) / 153;
+
+    *day   = dayOfYear - (153 * shiftedMonth + 2) / 5 + 1;
+    *month = (shiftedMonth < 10) ? shiftedMonth + 3 : shiftedMonth - 9;
+    *year  = era * 400 + yearOfEra + (*month <= 2);
 }
 
 /**
  * Method used to get the day from a date.
  * 
- * @param  Pointer to date used to return.
+ * @param  Date used to return.
  * @return Day integer.
  */
-int date_getDay(const Date *date) {
-    return date->day;
+int date_getDay(Date date) {
+    int day, month, year;
+    date_split(date, &day, &month, &year);
+    return day;
 }
 
 /**
  * Method used to get the month from a date.
  * 
- * @param  Pointer to date used to return.
+ * @param  Date used to return.
  * @return Month integer.
  */
-int date_getMonth(const Date *date) { 
-    return date->month;
+int date_getMonth(Date date) {
+    int day, month, year;
+    date_split(date, &day, &month, &year);
+    return month;
 }
 
 /**
  * Method used to get the year from a date.
  * 
- * @param  Pointer to date used to return.
+ * @param  Date used to return.
  * @return Year integer.
  */
-int date_getYear(const Date *date) {
-    return date->year;
+int date_getYear(Date date) {
+    int day, month, year;
+    date_split(date, &day, &month, &year);
+    return year;
 }
 
 /**
- * Get method to get formatted date string of a date.
+ * Method to format a date in the form "DD/MM/YYYY" into a buffer.
  * 
- * @param  Pointer to date used to return.
- * @return Formatted date string. 
+ * @param  Date to be formatted.
+ * @param  Buffer of at least DATE_BUFFER chars to write date to.
+ * @return Buffer containing formatted date string.
  */
-char *date_getDate(const Date *date) {
-     // Convert date variables into char
-    char *formattedDate = (char*)malloc(sizeof(char) * SALES_DATE_BUFFER);
-    snprintf(formattedDate, SALES_DATE_BUFFER, "%02d/%02d/%04d", 
-             date->day, date->month, date->year);
+char *date_format(Date date, char *buffer) {
+    int day, month, year;
+    date_split(date, &day, &month, &year);
 
-    return formattedDate;
+    // Write digits directly, years are always 4 digits
+    buffer[0]  = '0' + day / 10;
+    buffer[1]  = '0' + day % 10;
+    buffer[2]  = '/';
+    buffer[3]  = '0' + month / 10;
+    buffer[4]  = '0' + month % 10;
+    buffer[5]  = '/';
+    buffer[6]  = '0' + year / 1000;
+    buffer[7]  = '0' + (year / 100) % 10;
+    buffer[8]  = '0' + (year / 10) % 10;
+    buffer[9]  = '0' + year % 10;
+    buffer[10] = '\0';
+
+    return buffer;
 }
 
 /**
  * Method to print out a date.
  * 
- * @param  Pointer to date to be printed.
+ * @param  Date to be printed.
  * @return Print of date information.
  */
-void date_print(const Date *date) {
-        printf("\nDate: %s\n", date_getDate(date));
+void date_print(Date date) {
+    Report report;
+    report_init(&report, STDOUT_FILENO);
+    report_string(&report, "\nDate: ");
+    report_date(&report, date);
+    report_string(&report, "\n");
+    report_flush(&report);
 }
-
-/**
- * Method to free a date from memory.
- * 
- * @param Pointer to date to which will be freed from memory.
- */
-void date_free(Date *date) {
-    free(date);
-}
\ No newline at end of file
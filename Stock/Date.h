@@ -6,85 +6,119 @@
 #ifndef DATE_H
 #define DATE_H
 
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// Buffer size for a formatted date (Date length (10) + null terminator (1))
+#define DATE_BUFFER 11
+
+// Date value not used by any valid date
+#define DATE_NONE 0
+
 /**
- * Node structure defining and containing information about a date.
+ * Value type defining a date as a day ordinal, the number of days since
+ * 31/12/0000 in the Gregorian calendar, so 01/01/0001 is day 1. Later
+ * dates have greater ordinals, so dates are compared as integers.
  */
-typedef struct dateStruct {
-    int day, month, year;
-}
-Date;
+typedef int32_t Date;
 
 /**
- * Method to allocate memory for a new date containing information 
- * about itself. Or generates error message if memory allocation fails
- * and terminates program.
+ * Method to create a date from its day, month and year. Or generates error
+ * message if date is not valid and terminates program.
  * 
  * @param  Day integer, such as 9 without leading 0's.
  * @param  Month integer, such as 10 without leading 0's.
  * @param  Full year integer value, such as 2017.
- * @return Pointer to newly created date type.
+ * @return Date value.
  */
-Date* date_new(int day, int month, int year);
+Date date_new(int day, int month, int year);
 
 /**
- * Method to compare two dates and return the result of which one is newer. 
+ * Method to create a date from its day, month and year if it is valid.
  * 
- * @param  Pointer to date to compare against.
- * @param  Pointer to second date to compare against the first date.
- * @return Returns 0 if date 1 is newer than date 2 or 1 if older.
+ * @param  Day integer, such as 9 without leading 0's.
+ * @param  Month integer, such as 10 without leading 0's.
+ * @param  Full year integer value, such as 2017.
+ * @return Date value, or DATE_NONE if date is not valid.
  */
-int date_compare(const Date* date1, const Date* date2);
+Date date_fromDMY(int day, int month, int year);
+
+/**
+ * Method to parse a date in the fixed form "DD/MM/YYYY". The text does
+ * not need to be null terminated but must contain at least 10 chars.
+ * 
+ * @param  Pointer to first of 10 chars of date.
+ * @return Date value, or DATE_NONE if text is not a valid date in this
+ *         form.
+ */
+Date date_parse(const char *text);
+
+/**
+ * Method to compare two dates.
+ * 
+ * @param  Date to compare against.
+ * @param  Second date to compare against the first date.
+ * @return Negative if date 1 is older than date 2, 0 if they are the same
+ *         day or positive if date 1 is newer.
+ */
+static inline int date_compare(Date date1, Date date2) {
+    return (date1 > date2) - (date1 < date2);
+}
+
+/**
+ * Method to get the number of days from one date to another.
+ * 
+ * @param  Date to count from.
+ * @param  Date to count to.
+ * @return Integer number of days, negative if date 2 is older.
+ */
+static inline int date_difference(Date date1, Date date2) {
+    return date2 - date1;
+}
 
 /**
  * Method used to get the day from a date.
  * 
- * @param  Pointer to date used to return.
+ * @param  Date used to return.
  * @return Day integer.
  */
-int date_getDay(const Date *date);
+int date_getDay(Date date);
 
 /**
  * Method used to get the month from a date.
  * 
- * @param  Pointer to date used to return.
+ * @param  Date used to return.
  * @return Month integer.
  */
-int date_getMonth(const Date *date);
+int date_getMonth(Date date);
 
 /**
  * Method used to get the year from a date.
  * 
- * @param  Pointer to date used to return.
+ * @param  Date used to return.
  * @return Year integer.
  */
-int date_getYear(const Date *date);
+int date_getYear(Date date);
 
 /**
- * Get method to get formatted date string of a date.
+ * Method to format a date in the form "DD/MM/YYYY" into a buffer.
  * 
- * @param  Pointer to date used to return.
- * @return Formatted date string. 
+ * @param  Date to be formatted.
+ * @param  Buffer of at least DATE_BUFFER chars to write date to.
+ * @return Buffer containing formatted date string.
  */
-char *date_getDate(const Date *date);
+char *date_format(Date date, char *buffer);
 
 /**
  * Method to print out a date.
  * 
- * @param  Pointer to date to be printed.
+ * @param  Date to be printed.
  * @return Print of date information.
  */
-void date_print(const Date *date);
-
-/**
- * Method to free a date from memory.
- * 
- * @param Pointer to date to which will be freed from memory.
- */
-void date_free(Date *date);
+void date_print(Date date);
 
 #ifdef __cplusplus
 }
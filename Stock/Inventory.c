@@ -5,10 +5,195 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 
 #include "Inventory.h"
 #include "StockItem.h"
 
+// Initial number of slots in the ID index, must be a power of two
+const int INVENTORY_INDEX_MIN_CAPACITY = 64;
+
+// Marker stored in index slots whose stock item has been removed, so that
+// probe sequences running through them are not cut short
+static StockItem INVENTORY_INDEX_REMOVED;
+
+/**
+ * Method to hash a stock item ID using the FNV-1a algorithm.
+ * 
+ * @param  Char ID to be hashed, need not be null terminated.
+ * @param  Length of ID.
+ * @return Unsigned hash of ID.
+ */
+static unsigned int inventory_hash(const char *ID, size_t length) {
+    unsigned int hash = 2166136261u;
+    for (size_t i = 0; i < length; i++)
+        hash = (hash ^ (unsigned char)ID[i]) * 16777619u;
+    
+    return hash;
+}
+
+/**
+ * Method to allocate an empty ID index table. Or generates error message 
+ * if memory allocation fails and terminates program.
+ * 
+ * @param  Integer number of slots, must be a power of two.
+ * @return Pointer to newly created index table.
+ */
+static InventoryIndexSlot *inventory_indexNew(int capacity) {
+    // Allocate zeroed slots, a null stock item marks a slot as empty
+    InventoryIndexSlot *index = (InventoryIndexSlot*)calloc(capacity, 
+            sizeof(InventoryIndexSlot));
+    // Null check memory allocation
+    if (!index) {
+        fprintf(stderr, "Error: Unable to allocate memory in "
+                "inventory_indexNew().\n");
+        exit(EXIT_FAILURE);
+    }
+    
+    return index;
+}
+
+/**
+ * Method to find the index slot of a ID, or the empty slot where it 
+ * would be placed if the ID is not in the index.
+ * 
+ * @param  Pointer to inventory containing index.
+ * @param  Char ID to find, need not be null terminated.
+ * @param  Length of ID.
+ * @param  Unsigned hash of ID.
+ * @return Pointer to matching slot or first free slot in probe sequence.
+ */
+static InventoryIndexSlot *inventory_indexProbe(const Inventory* inventory, 
+        const char *ID, size_t length, unsigned int hash) {
+    unsigned int mask = inventory->indexCapacity - 1;
+    InventoryIndexSlot *vacant = NULL;
+    
+    // Linear probe until ID or a never used slot is found
+    for (unsigned int i = hash & mask; ; i = (i + 1) & mask) {
+        InventoryIndexSlot *slot = &inventory->index[i];
+        
+        if (slot->item == NULL)
+            return vacant ? vacant : slot;
+        else if (slot->item == &INVENTORY_INDEX_REMOVED) {
+            // Remember first removed slot so it can be reused
+            if (!vacant)
+                vacant = slot;
+        }
+        else if (slot->hash == hash) {
+            const char *slotID = stockItem_getID(slot->item);
+            if ((strncmp(slotID, ID, length) == 0) 
+                    && (slotID[length] == '\0'))
+                return slot;
+        }
+    }
+}
+
+/**
+ * Method to rebuild the ID index with a new number of slots, dropping
+ * any removed markers.
+ * 
+ * @param Pointer to inventory containing index.
+ * @param Integer new number of slots, must be a power of two.
+ */
+static void inventory_indexResize(Inventory* inventory, int capacity) {
+    InventoryIndexSlot *old = inventory->index;
+    int oldCapacity = inventory->indexCapacity;
+    
+    inventory->index         = inventory_indexNew(capacity);
+    inventory->indexCapacity = capacity;
+    inventory->indexUsed     = inventory->indexCount;
+    
+    // Reinsert all live stock items
+    for (int i = 0; i < oldCapacity; i++)
+        if (old[i].item && (old[i].item != &INVENTORY_INDEX_REMOVED)) {
+            const char *ID = stockItem_getID(old[i].item);
+            *inventory_indexProbe(inventory, ID, strlen(ID), 
+                    old[i].hash) = old[i];
+        }
+    
+    free(old);
+}
+
+/**
+ * Method to add a stock item to the ID index.
+ * 
+ * @param  Pointer to inventory containing index.
+ * @param  Pointer to stock item to be indexed.
+ * @return 1 if stock item was indexed or 0 if its ID is already indexed.
+ */
+static int inventory_indexAdd(Inventory* inventory, StockItem *item) {
+    // Keep load, including removed markers, under 3/4
+    if ((inventory->indexUsed + 1) * 4 > inventory->indexCapacity * 3) {
+        int capacity = inventory->indexCapacity;
+        while ((inventory->indexCount + 1) * 2 > capacity)
+            capacity *= 2;
+        inventory_indexResize(inventory, capacity);
+    }
+    
+    const char *ID = stockItem_getID(item);
+    unsigned int hash = inventory_hash(ID, strlen(ID));
+    InventoryIndexSlot *slot = inventory_indexProbe(inventory, ID, 
+            strlen(ID), hash);
+    
+    // Reject duplicate IDs
+    if (slot->item && (slot->item != &INVENTORY_INDEX_REMOVED))
+        return 0;
+    
+    // Only never used slots increase the used count
+    if (slot->item == NULL)
+        inventory->indexUsed++;
+    slot->hash = hash;
+    slot->item = item;
+    inventory->indexCount++;
+    
+    return 1;
+}
+
+/**
+ * Method to remove a stock item from the ID index.
+ * 
+ * @param Pointer to inventory containing index.
+ * @param Pointer to stock item to be removed.
+ */
+static void inventory_indexRemove(Inventory* inventory, StockItem *item) {
+    const char *ID = stockItem_getID(item);
+    InventoryIndexSlot *slot = inventory_indexProbe(inventory, ID, 
+            strlen(ID), inventory_hash(ID, strlen(ID)));
+    
+    // Replace with removed marker so later probes carry on past it
+    if (slot->item == item) {
+        slot->item = &INVENTORY_INDEX_REMOVED;
+        inventory->indexCount--;
+    }
+}
+
+/**
+ * Method to give a stock item the next item index, growing the item table
+ * as needed. Or generates error message if memory allocation fails and 
+ * terminates program.
+ * 
+ * @param Pointer to inventory containing item table.
+ * @param Pointer to stock item to be given a index.
+ */
+static void inventory_itemsAdd(Inventory* inventory, StockItem *item) {
+    if (inventory->itemCount == inventory->itemCapacity) {
+        inventory->itemCapacity = inventory->itemCapacity 
+                ? inventory->itemCapacity * 2 : INVENTORY_INDEX_MIN_CAPACITY;
+        inventory->items = (StockItem**)realloc(inventory->items, 
+                sizeof(StockItem*) * inventory->itemCapacity);
+        // Null check memory allocation
+        if (!inventory->items) {
+            fprintf(stderr, "Error: Unable to allocate memory in "
+                    "inventory_itemsAdd().\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    
+    item->index = inventory->itemCount;
+    inventory->items[inventory->itemCount++] = item;
+}
+
 /**
  * Method to allocate memory for a new inventory of stock items. Or 
  * generates error message if memory allocation fails and terminates program.
@@ -29,27 +214,48 @@ Inventory* inventory_new() {
     inventory->first = NULL;
     inventory->last  = NULL;
     
+    // Create empty ID index
+    inventory->index         = inventory_indexNew(INVENTORY_INDEX_MIN_CAPACITY);
+    inventory->indexCapacity = INVENTORY_INDEX_MIN_CAPACITY;
+    inventory->indexCount    = 0;
+    inventory->indexUsed     = 0;
+    
+    // Create empty item table and aggregate set
+    inventory->items        = NULL;
+    inventory->itemCount    = 0;
+    inventory->itemCapacity = 0;
+    inventory->aggregates   = aggregateSet_new();
+    arena_init(&inventory->arena);
+    pool_init(&inventory->nodes, sizeof(InventoryNode));
+    inventory->modifications = 0;
+    
     return inventory;
 }
 
 /**
  * Method to append a new stock item to the tail of a inventory. 
  * Or generates error message if memory allocation fails and terminates 
- * program.
+ * program. Stock items with an ID already in the inventory are rejected.
  * 
- * @param Pointer to inventory of which will be appended to.
- * @param Pointer to Stock Item that will be appended to inventory.
+ * @param  Pointer to inventory of which will be appended to.
+ * @param  Pointer to Stock Item that will be appended to inventory.
+ * @return 1 if stock item was added or 0 if its ID is a duplicate.
  */
-void inventory_add(Inventory* inventory, StockItem *item) {
-    // Allocate node to memory
-    InventoryNode* node = (InventoryNode*)malloc(sizeof(InventoryNode));
-    // Null check memory allocation
-    if (!node) {
-        fprintf(stderr, "Error: Unable to allocate memory "
-                "in inventory_add().\n");
-        exit(EXIT_FAILURE);
+int inventory_add(Inventory* inventory, StockItem *item) {
+    // Index stock item, rejecting it if its ID is already in use
+    if (!inventory_indexAdd(inventory, item)) {
+        fprintf(stderr, "Error: Duplicate stock item ID %s rejected in "
+                "inventory_add().\n", stockItem_getID(item));
+        return 0;
     }
     
+    // Give stock item its index and count it in all aggregates
+    inventory_itemsAdd(inventory, item);
+    aggregateSet_include(inventory->aggregates, item, 0);
+    inventory->modifications++;
+    // Take node from pool
+    InventoryNode* node = (InventoryNode*)pool_alloc(&inventory->nodes);
+    
     // Pass in stock item
     node->item = item;
     node->next = NULL;
@@ -60,26 +266,34 @@ void inventory_add(Inventory* inventory, StockItem *item) {
     // Else add to tail of inventory
     else
         inventory->last = inventory->last->next = node;
+    
+    return 1;
 }
 
 /**
  * Method to append a new stock item to the head of a inventory. 
  * Or generates error message if memory allocation fails and terminates 
- * program.
+ * program. Stock items with an ID already in the inventory are rejected.
  * 
- * @param Pointer to inventory of which will be appended to.
- * @param Pointer to Stock Item that will be appended to inventory.
+ * @param  Pointer to inventory of which will be appended to.
+ * @param  Pointer to Stock Item that will be appended to inventory.
+ * @return 1 if stock item was added or 0 if its ID is a duplicate.
  */
-void inventory_insert(Inventory* inventory, StockItem *item) {
-    // Allocate node to memory
-    InventoryNode* node = (InventoryNode*)malloc(sizeof(InventoryNode));
-    // Null check memory allocation
-    if (!node) {
-        fprintf(stderr, "Error: Unable to allocate memory "
-                "in inventory_add().\n");
-        exit(EXIT_FAILURE);
+int inventory_insert(Inventory* inventory, StockItem *item) {
+    // Index stock item, rejecting it if its ID is already in use
+    if (!inventory_indexAdd(inventory, item)) {
+        fprintf(stderr, "Error: Duplicate stock item ID %s rejected in "
+                "inventory_insert().\n", stockItem_getID(item));
+        return 0;
     }
     
+    // Give stock item its index and count it in all aggregates
+    inventory_itemsAdd(inventory, item);
+    aggregateSet_include(inventory->aggregates, item, 0);
+    inventory->modifications++;
+    // Take node from pool
+    InventoryNode* node = (InventoryNode*)pool_alloc(&inventory->nodes);
+    
     node->item = item;
     node->next = inventory->first;
     
@@ -89,6 +303,8 @@ void inventory_insert(Inventory* inventory, StockItem *item) {
     // Else add to head of inventory
     else
         inventory->first = node;
+    
+    return 1;
 }
 
 /**
@@ -142,8 +358,15 @@ StockItem *inventory_removeTail(Inventory* inventory) {
         inventory->last->next = NULL;
     }
     
-    // Free tail from memory
-    free(tail);
+    // Release tail to pool
+    pool_release(&inventory->nodes, tail);
+    
+    // Remove stock item from ID index, item table and aggregates
+    inventory_indexRemove(inventory, item);
+    inventory->items[item->index] = NULL;
+    item->index = -1;
+    aggregateSet_exclude(item);
+    inventory->modifications++;
     
     return item;
 }
@@ -176,71 +399,235 @@ StockItem *inventory_removeHead(Inventory* inventory) {
     else
         inventory->first = inventory->first->next;  
         
-    // Free head from memory
-    free(head);
+    // Release head to pool
+    pool_release(&inventory->nodes, head);
+    
+    // Remove stock item from ID index, item table and aggregates
+    inventory_indexRemove(inventory, item);
+    inventory->items[item->index] = NULL;
+    item->index = -1;
+    aggregateSet_exclude(item);
+    inventory->modifications++;
     
     return item;
 }
 
 /**
  * Method to find and return a specific stock item by ID within
- * a inventory list.
+ * a inventory list, using the inventory ID index.
  * 
  * @param  Pointer to inventory to be scanned.
  * @param  Char ID of stock item to find.
  * @return Stock Item with the ID of the parameter passed in.
  */
 StockItem *inventory_find(const Inventory* inventory, const char *ID) {
-    // Loop and compare all nodes against ID
-    if (inventory->first != NULL)
-        for (InventoryNode *node = inventory->first; node != NULL; 
-                node = node->next) {
-            // Get stock item to compare
-            StockItem *item = node->item;
-
-            // Compare this items ID against passed in ID
-            if(strcmp(stockItem_getID(item), ID) == 0)
-                return item;
-        }   
+    return inventory_findSlice(inventory, ID, strlen(ID));
+}
+
+/**
+ * Method to find and return a specific stock item by a ID that is not
+ * null terminated, such as a slice of a line being parsed.
+ * 
+ * @param  Pointer to inventory to be scanned.
+ * @param  Char ID of stock item to find.
+ * @param  Length of ID.
+ * @return Stock Item with the ID of the parameter passed in.
+ */
+StockItem *inventory_findSlice(const Inventory* inventory, const char *ID,
+        size_t length) {
+    // Look up ID within index
+    InventoryIndexSlot *slot = inventory_indexProbe(inventory, ID, length,
+            inventory_hash(ID, length));
+    if (slot->item && (slot->item != &INVENTORY_INDEX_REMOVED))
+        return slot->item;
+    
     // Display error message if nothing was found
-    fprintf(stderr, "Error: Stock item ID %s not found in"
-            "inventory_find().\n", ID);
+    fprintf(stderr, "Error: Stock item ID %.*s not found in"
+            "inventory_find().\n", (int)length, ID);
     return NULL;
 }
 
 /**
- * Method to sort inventory by order of increasing price,
- * using the bubble sort algorithm.
+ * Entry used while sorting, pairing a node with its precomputed sort key 
+ * so comparisons do not need to visit the stock item.
+ */
+typedef struct InventorySortEntryStruct {
+    long long key;
+    const char *text;
+    InventoryNode *node;
+}
+InventorySortEntry;
+
+/**
+ * Method to compare two sort entries.
+ * 
+ * @param  Pointer to first entry.
+ * @param  Pointer to second entry.
+ * @param  Integer 1 for ascending or -1 for descending text order.
+ * @return Negative, zero or positive if first entry sorts before, equal to
+ *         or after second entry.
+ */
+static inline int inventory_compare(const InventorySortEntry *entry1, 
+        const InventorySortEntry *entry2, int direction) {
+    // Text keys compare their strings, numeric keys are already negated
+    // for descending order
+    if (entry1->text)
+        return direction * strcmp(entry1->text, entry2->text);
+    return (entry1->key > entry2->key) - (entry1->key < entry2->key);
+}
+
+/**
+ * Method to sort inventory by order of increasing price.
  * 
  * @param Inventory pointer to inventory to be sorted.
  */
 void inventory_sort(Inventory* inventory) {  
+    inventory_sortBy(inventory, INVENTORY_SORT_PRICE, 
+            INVENTORY_SORT_ASCENDING);
+}
+
+/**
+ * Method to sort inventory on a key in ascending or descending order, using
+ * a stable bottom up merge sort over an array of the inventory nodes which
+ * are then relinked in sorted order. Stock items with equal keys keep their 
+ * current order.
+ * 
+ * @param Inventory pointer to inventory to be sorted.
+ * @param Key to sort stock items on.
+ * @param Order to sort stock items in.
+ */
+void inventory_sortBy(Inventory* inventory, InventorySortKey key, 
+        InventorySortOrder order) {
     // Only sort if inventory contains at least 2 different nodes
-    if (inventory->first != inventory->last)
-    {
-        // State of sorted
-        int sorted;
-
-        // Loop while not sorted
-        do {
-            sorted = 1; 
-
-            // Loop all nodes
-            for (InventoryNode* node = inventory->first; node->next != NULL; 
-                    node = node->next) {
-                // Get items to be sorted
-                StockItem *item  = node->item;
-                StockItem *nextItem  = node->next->item;
-                
-                // If this item is worth more than next item swap positions
-                if (stockItem_getPrice(item) > stockItem_getPrice(nextItem)) {
-                   node->item        = nextItem;
-                   node->next->item  = item;
-                   sorted            = 0;
-                }
-            }
-        } while (!sorted);
+    if (inventory->first == inventory->last)
+        return;
+    
+    int count = inventory_count(inventory);
+    int direction = (order == INVENTORY_SORT_DESCENDING) ? -1 : 1;
+    
+    // Allocate entries and merge buffer
+    InventorySortEntry *entries = (InventorySortEntry*)malloc(
+            sizeof(InventorySortEntry) * count * 2);
+    // Null check memory allocation
+    if (!entries) {
+        fprintf(stderr, "Error: Unable to allocate memory in "
+                "inventory_sortBy().\n");
+        exit(EXIT_FAILURE);
+    }
+    InventorySortEntry *buffer = entries + count;
+    
+    // Extract key of each node, in pennies so no float is compared
+    int n = 0;
+    for (InventoryNode* node = inventory->first; node != NULL; 
+            node = node->next, n++) {
+        StockItem *item = node->item;
+        entries[n].node = node;
+        entries[n].key  = 0;
+        entries[n].text = NULL;
+        
+        switch (key) {
+            case INVENTORY_SORT_PRICE:
+                entries[n].key = stockItem_getPennies(item);
+                break;
+            case INVENTORY_SORT_QUANTITY:
+                entries[n].key = stockItem_getQuantity(item);
+                break;
+            case INVENTORY_SORT_TYPE:
+                entries[n].text = stockItem_getType(item);
+                break;
+            case INVENTORY_SORT_ID:
+                entries[n].text = stockItem_getID(item);
+                break;
+            case INVENTORY_SORT_VALUE:
+                entries[n].key = (long long)stockItem_getPennies(item) 
+                        * stockItem_getQuantity(item);
+                break;
+        }
+        entries[n].key *= direction;
+    }
+    
+    // Merge sorted runs of width 1, 2, 4... between entries and buffer
+    for (int width = 1; width < count; width *= 2) {
+        for (int start = 0; start < count; start += width * 2) {
+            int middle = (start + width < count) ? start + width : count;
+            int end = (middle + width < count) ? middle + width : count;
+            int left = start, right = middle;
+            
+            // Take from left run on ties to stay stable
+            for (int i = start; i < end; i++)
+                if ((left < middle) && ((right >= end) 
+                        || (inventory_compare(&entries[left], 
+                        &entries[right], direction) <= 0)))
+                    buffer[i] = entries[left++];
+                else
+                    buffer[i] = entries[right++];
+        }
+        
+        // Swap entries and buffer for next pass
+        InventorySortEntry *swap = entries;
+        entries = buffer;
+        buffer  = swap;
     }
+    
+    // Relink nodes in sorted order
+    for (int i = 0; i < count - 1; i++)
+        entries[i].node->next = entries[i + 1].node;
+    entries[count - 1].node->next = NULL;
+    inventory->first = entries[0].node;
+    inventory->last  = entries[count - 1].node;
+    inventory->modifications++;
+    
+    // Free whichever half holds the start of the allocation
+    free((entries < buffer) ? entries : buffer);
+}
+
+/**
+ * Method to register a aggregate summing a measure over all stock items
+ * matching a predicate. The total is computed once here and then kept up
+ * to date as stock items are added, removed and sold, so reading it is
+ * O(1). Or generates error message if too many aggregates are registered 
+ * and terminates program.
+ * 
+ * @param  Pointer to inventory to be aggregated.
+ * @param  Measure to be summed.
+ * @param  Predicate deciding which stock items are summed, such as 
+ *         aggregate_filter().
+ * @param  Pointer to context passed to predicate, must outlive inventory.
+ * @return Integer ID of aggregate.
+ */
+int inventory_registerAggregate(Inventory* inventory, 
+        AggregateMeasure measure, AggregatePredicate predicate, 
+        const void *context) {
+    int aggregate = aggregateSet_register(inventory->aggregates, measure, 
+            predicate, context);
+    
+    // Compute initial total from existing stock items
+    for (InventoryNode* node = inventory->first; node != NULL; 
+            node = node->next)
+        aggregateSet_include(inventory->aggregates, node->item, aggregate);
+    
+    return aggregate;
+}
+
+/**
+ * Get method to get the current total of a registered aggregate.
+ * 
+ * @param  Pointer to inventory containing aggregate.
+ * @param  Integer ID of aggregate.
+ * @return Current total of aggregate.
+ */
+long long inventory_getAggregate(const Inventory* inventory, int aggregate) {
+    return aggregateSet_get(inventory->aggregates, aggregate);
+}
+
+/**
+ * Method to get the occupancy of the slabs holding a inventory's nodes.
+ * 
+ * @param Pointer to inventory.
+ * @param Pointer to where statistics will be stored.
+ */
+void inventory_getNodeStats(const Inventory* inventory, PoolStats *stats) {
+    pool_getStats(&inventory->nodes, stats);
 }
 
 /**
@@ -255,34 +642,61 @@ void inventory_clear(Inventory* inventory) {
         InventoryNode* node = inventory->first;
         inventory->first = node->next;
         
-        // Free node from memory
-        free(node);
+        // Remove stock item from aggregates
+        node->item->index = -1;
+        aggregateSet_exclude(node->item);
+        
+        // Release node to pool
+        pool_release(&inventory->nodes, node);
     }
+    inventory->last = NULL;
+    
+    // Empty ID index
+    memset(inventory->index, 0, 
+            sizeof(InventoryIndexSlot) * inventory->indexCapacity);
+    inventory->indexCount = 0;
+    inventory->indexUsed  = 0;
+    
+    // Empty item table
+    inventory->itemCount = 0;
+    inventory->modifications++;
 }
 
 /**
- * Method to print all elements within a inventory to the console.
+ * Method to write all elements within a inventory to a report.
  * 
- * @param Pointer to inventory to be printed.
+ * @param Pointer to report writer.
+ * @param Pointer to inventory to be written.
  */
-void inventory_print(const Inventory* inventory) {
-    // Loop and print all nodes if inventory is not empty
+void inventory_write(Report *report, const Inventory* inventory) {
+    // Loop and write all nodes if inventory is not empty
     if (inventory->first != NULL)
         for (InventoryNode* node = inventory->first; node != NULL; 
-                node = node->next) {
-            // Get stock item to print
-            StockItem *item = node->item;
-            
-            // Print item information to console
-            stockItem_print(item);
-        }
-    // Else display empty message to console
+                node = node->next)
+            stockItem_write(report, node->item);
+    // Else write empty message
     else
-        printf("\nInventory currently empty.\n");
+        report_string(report, "\nInventory currently empty.\n");
+}
+
+/**
+ * Method to print all elements within a inventory to the console.
+ * 
+ * @param Pointer to inventory to be printed.
+ */
+void inventory_print(const Inventory* inventory) {
+    Report report;
+    report_init(&report, STDOUT_FILENO);
+    inventory_write(&report, inventory);
+    report_flush(&report);
 }
 
 /**
- * Method to free inventory from memory.
+ * Method to free inventory from memory, along with any stock items 
+ * allocated from its arena, such as those read by loader_readInventory()
+ * or snapshot_load() and the copies held by a view. Stock items added 
+ * with stockItem_new() are not freed. Sales lists referring to stock 
+ * items freed this way must not be used afterwards.
  * 
  * @param Pointer to inventory to which will be freed from memory.
  */
@@ -290,5 +704,10 @@ void inventory_free(Inventory* inventory) {
     // Free all nodes from inventory before freeing inventory
     inventory_clear(inventory);
 
+    free(inventory->index);
+    free(inventory->items);
+    aggregateSet_free(inventory->aggregates);
+    arena_free(&inventory->arena);
+    pool_free(&inventory->nodes);
     free(inventory);
 }
@@ -6,7 +6,13 @@
 #ifndef INVENTORY_H
 #define INVENTORY_H
 
+#include <stddef.h>
+
 #include "StockItem.h"
+#include "Aggregate.h"
+#include "Arena.h"
+#include "Pool.h"
+#include "Report.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -22,15 +28,60 @@ typedef struct InventoryNodeStruct {
 }
 InventoryNode;
 
+/**
+ * Slot structure used by the inventory ID index, an open addressing hash
+ * table mapping stock item IDs to their stock items.
+ */
+typedef struct InventoryIndexSlotStruct {
+    unsigned int hash;
+    StockItem *item;
+}
+InventoryIndexSlot;
+
 /**
  * Inventory type structure defining and containing node information.
  */
 typedef struct InventoryStruct {
     InventoryNode* first;
     InventoryNode* last;
+    // ID index, capacity is always a power of two
+    InventoryIndexSlot *index;
+    int indexCapacity, indexCount, indexUsed;
+    // Stock items by item index, removed items leave a null entry
+    StockItem **items;
+    int itemCount, itemCapacity;
+    // Aggregates kept up to date as stock items are added, removed and sold
+    AggregateSet *aggregates;
+    // Stock items and strings read from files, freed with the inventory
+    Arena arena;
+    // Nodes, reused once removed
+    Pool nodes;
+    // Number of times stock items have been added, removed or reordered
+    unsigned long modifications;
 }
 Inventory;
 
+/**
+ * Keys an inventory can be sorted on.
+ */
+typedef enum InventorySortKeyEnum {
+    INVENTORY_SORT_PRICE,
+    INVENTORY_SORT_QUANTITY,
+    INVENTORY_SORT_TYPE,
+    INVENTORY_SORT_ID,
+    INVENTORY_SORT_VALUE
+}
+InventorySortKey;
+
+/**
+ * Orders an inventory can be sorted in.
+ */
+typedef enum InventorySortOrderEnum {
+    INVENTORY_SORT_ASCENDING,
+    INVENTORY_SORT_DESCENDING
+}
+InventorySortOrder;
+
 /**
  * Definition for iterator type used to iterate through inventory nodes.
  */
@@ -56,6 +107,18 @@ static inline InventoryIterator inventory_last(const Inventory *inventory) {
     return inventory->last;
 }
 
+/**
+ * Get method to get the arena of a inventory, for memory that lives as 
+ * long as the inventory, such as stock items read from a file and their 
+ * strings. Stock items allocated from it must not be freed on their own.
+ * 
+ * @param  Pointer to inventory.
+ * @return Pointer to arena of inventory.
+ */
+static inline Arena *inventory_getArena(Inventory *inventory) {
+    return &inventory->arena;
+}
+
 /**
  * Method to get the next node.
  * 
@@ -79,7 +142,8 @@ static inline InventoryIterator inventory_iteratorGetStockItem
 }
 
 /**
- * Method to set and update the current stock item of a iterator.
+ * Method to set and update the current stock item of a iterator. The new
+ * stock item is not added to the inventory ID index.
  * 
  * @param  Iterator to be changed.
  */
@@ -99,22 +163,24 @@ Inventory* inventory_new();
 /**
  * Method to append a new stock item to the tail of a inventory. 
  * Or generates error message if memory allocation fails and terminates 
- * program.
+ * program. Stock items with an ID already in the inventory are rejected.
  * 
- * @param Pointer to inventory of which will be appended to.
- * @param Pointer to Stock Item that will be appended to inventory.
+ * @param  Pointer to inventory of which will be appended to.
+ * @param  Pointer to Stock Item that will be appended to inventory.
+ * @return 1 if stock item was added or 0 if its ID is a duplicate.
  */
-void inventory_add(Inventory* inventory, StockItem *item);
+int inventory_add(Inventory* inventory, StockItem *item);
 
 /**
  * Method to append a new stock item to the head of a inventory. 
  * Or generates error message if memory allocation fails and terminates 
- * program.
+ * program. Stock items with an ID already in the inventory are rejected.
  * 
- * @param Pointer to inventory of which will be appended to.
- * @param Pointer to Stock Item that will be appended to inventory.
+ * @param  Pointer to inventory of which will be appended to.
+ * @param  Pointer to Stock Item that will be appended to inventory.
+ * @return 1 if stock item was added or 0 if its ID is a duplicate.
  */
-void inventory_insert(Inventory* inventory, StockItem *item);
+int inventory_insert(Inventory* inventory, StockItem *item);
 
 /**
  * Method to return the number of stock items currently stored in a inventory.
@@ -144,7 +210,7 @@ StockItem *inventory_removeHead(Inventory* inventory);
 
 /**
  * Method to find and return a specific stock item by ID within
- * a inventory list.
+ * a inventory list, using the inventory ID index.
  * 
  * @param  Pointer to inventory to be scanned.
  * @param  Char ID of stock item to find.
@@ -153,13 +219,94 @@ StockItem *inventory_removeHead(Inventory* inventory);
 StockItem *inventory_find(const Inventory* inventory, const char *ID);
 
 /**
- * Method to sort inventory by ascending order on each stock items price,
- * using the bubble sort algorithm.
+ * Method to find and return a specific stock item by a ID that is not
+ * null terminated, such as a slice of a line being parsed.
+ * 
+ * @param  Pointer to inventory to be scanned.
+ * @param  Char ID of stock item to find.
+ * @param  Length of ID.
+ * @return Stock Item with the ID of the parameter passed in.
+ */
+StockItem *inventory_findSlice(const Inventory* inventory, const char *ID,
+        size_t length);
+
+/**
+ * Method to get a stock item by its item index.
+ * 
+ * @param  Pointer to inventory containing stock item.
+ * @param  Integer item index, see stockItem_getIndex().
+ * @return Stock item, or null if it has been removed.
+ */
+static inline StockItem *inventory_getItem(const Inventory* inventory, 
+        int index) {
+    return inventory->items[index];
+}
+
+/**
+ * Method to get the number of item indexes given out by a inventory, 
+ * including those of removed stock items.
+ * 
+ * @param  Pointer to inventory to be checked.
+ * @return Integer one past the highest item index.
+ */
+static inline int inventory_itemCount(const Inventory* inventory) {
+    return inventory->itemCount;
+}
+
+/**
+ * Method to sort inventory by ascending order on each stock items price.
  * 
  * @param Inventory pointer to inventory to be sorted.
  */
 void inventory_sort(Inventory* inventory);
 
+/**
+ * Method to sort inventory on a key in ascending or descending order, using
+ * a stable bottom up merge sort which relinks the inventory nodes. Stock 
+ * items with equal keys keep their current order.
+ * 
+ * @param Inventory pointer to inventory to be sorted.
+ * @param Key to sort stock items on.
+ * @param Order to sort stock items in.
+ */
+void inventory_sortBy(Inventory* inventory, InventorySortKey key, 
+        InventorySortOrder order);
+
+/**
+ * Method to register a aggregate summing a measure over all stock items
+ * matching a predicate. The total is computed once here and then kept up
+ * to date as stock items are added, removed and sold, so reading it is
+ * O(1). Or generates error message if too many aggregates are registered 
+ * and terminates program.
+ * 
+ * @param  Pointer to inventory to be aggregated.
+ * @param  Measure to be summed.
+ * @param  Predicate deciding which stock items are summed, such as 
+ *         aggregate_filter().
+ * @param  Pointer to context passed to predicate, must outlive inventory.
+ * @return Integer ID of aggregate.
+ */
+int inventory_registerAggregate(Inventory* inventory, 
+        AggregateMeasure measure, AggregatePredicate predicate, 
+        const void *context);
+
+/**
+ * Get method to get the current total of a registered aggregate.
+ * 
+ * @param  Pointer to inventory containing aggregate.
+ * @param  Integer ID of aggregate.
+ * @return Current total of aggregate.
+ */
+long long inventory_getAggregate(const Inventory* inventory, int aggregate);
+
+/**
+ * Method to get the occupancy of the slabs holding a inventory's nodes.
+ * 
+ * @param Pointer to inventory.
+ * @param Pointer to where statistics will be stored.
+ */
+void inventory_getNodeStats(const Inventory* inventory, PoolStats *stats);
+
 /**
  * Method to clear all the elements within a inventory structure.
  *  
@@ -167,6 +314,14 @@ void inventory_sort(Inventory* inventory);
  */
 void inventory_clear(Inventory* inventory);
 
+/**
+ * Method to write all elements within a inventory to a report.
+ * 
+ * @param Pointer to report writer.
+ * @param Pointer to inventory to be written.
+ */
+void inventory_write(Report *report, const Inventory* inventory);
+
 /**
  * Method to print all elements within a inventory to the console.
  * 
@@ -175,7 +330,11 @@ void inventory_clear(Inventory* inventory);
 void inventory_print(const Inventory* inventory);
 
 /**
- * Method to free inventory from memory.
+ * Method to free inventory from memory, along with any stock items 
+ * allocated from its arena, such as those read by loader_readInventory()
+ * or snapshot_load() and the copies held by a view. Stock items added 
+ * with stockItem_new() are not freed. Sales lists referring to stock 
+ * items freed this way must not be used afterwards.
  * 
  * @param Pointer to inventory to which will be freed from memory.
  */
@@ -0,0 +1,190 @@
+/* 
+ * File:   InventoryColumns.c
+ * Author: Paulo Jorge
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "InventoryColumns.h"
+
+/**
+ * Method to allocate memory for a column. Or generates error message if 
+ * memory allocation fails and terminates program.
+ * 
+ * @param  Integer number of bytes to allocate.
+ * @return Pointer to newly allocated column.
+ */
+static void *inventoryColumns_alloc(size_t size) {
+    // Always allocate at least one byte so empty inventories succeed
+    void *column = malloc(size ? size : 1);
+    // Null check memory allocation
+    if (!column) {
+        fprintf(stderr, "Error: Unable to allocate memory in "
+                "inventoryColumns_build().\n");
+        exit(EXIT_FAILURE);
+    }
+    
+    return column;
+}
+
+/**
+ * Method to free every column, leaving the columns structure itself.
+ * 
+ * @param Pointer to columns to be emptied.
+ */
+static void inventoryColumns_clear(InventoryColumns *columns) {
+    free(columns->items);
+    free(columns->quantity);
+    free(columns->price);
+    free(columns->type);
+    free(columns->attributeKind);
+    free(columns->attribute);
+    free(columns->ID);
+    free(columns->desc);
+    free(columns->strings);
+}
+
+/**
+ * Method to build every column from the current stock items of the 
+ * inventory, in inventory order. Or generates error message if memory 
+ * allocation fails and terminates program.
+ * 
+ * @param Pointer to columns to be built, holding no columns.
+ */
+static void inventoryColumns_build(InventoryColumns *columns) {
+    const Inventory *inventory = columns->inventory;
+    int count = inventory_count(inventory);
+    
+    // Size string table to fit every ID and description
+    size_t stringsSize = 0;
+    for (InventoryIterator i = inventory_first(inventory); i != NULL; 
+            i = inventory_iteratorNext(i))
+        stringsSize += strlen(stockItem_getID(i->item)) 
+                + strlen(stockItem_getDesc(i->item)) + 2;
+    
+    // Allocate columns
+    columns->modifications = inventory->modifications;
+    columns->count         = count;
+    columns->items         = (StockItem**)inventoryColumns_alloc(
+            sizeof(StockItem*) * count);
+    columns->quantity      = (int*)inventoryColumns_alloc(sizeof(int) * count);
+    columns->price         = (Money*)inventoryColumns_alloc(sizeof(Money) 
+            * count);
+    columns->type          = (unsigned char*)inventoryColumns_alloc(count);
+    columns->attributeKind = (unsigned char*)inventoryColumns_alloc(count);
+    columns->attribute     = (long long*)inventoryColumns_alloc(
+            sizeof(long long) * count);
+    columns->ID            = (size_t*)inventoryColumns_alloc(sizeof(size_t)
+            * count);
+    columns->desc          = (size_t*)inventoryColumns_alloc(sizeof(size_t)
+            * count);
+    columns->strings       = (char*)inventoryColumns_alloc(stringsSize);
+    
+    // Copy each stock item into its row
+    int row = 0;
+    size_t offset = 0;
+    for (InventoryIterator i = inventory_first(inventory); i != NULL; 
+            i = inventory_iteratorNext(i), row++) {
+        StockItem *item = i->item;
+        
+        columns->items[row]         = item;
+        columns->quantity[row]      = stockItem_getQuantity(item);
+        columns->price[row]         = stockItem_getPennies(item);
+        columns->type[row]          = stockItem_getTypeCode(item);
+        columns->attributeKind[row] = stockItem_getAttribute(item).kind;
+        columns->attribute[row]     = stockItem_getAttribute(item).value;
+        
+        // Append ID and description to string table
+        columns->ID[row] = offset;
+        strcpy(columns->strings + offset, stockItem_getID(item));
+        offset += strlen(stockItem_getID(item)) + 1;
+        columns->desc[row] = offset;
+        strcpy(columns->strings + offset, stockItem_getDesc(item));
+        offset += strlen(stockItem_getDesc(item)) + 1;
+    }
+}
+
+/**
+ * Method to build a columnar copy of a inventory. Or generates error 
+ * message if memory allocation fails and terminates program.
+ * 
+ * @param  Pointer to inventory to be copied.
+ * @return Pointer to newly created columns.
+ */
+InventoryColumns* inventoryColumns_new(const Inventory *inventory) {
+    InventoryColumns *columns = (InventoryColumns*)inventoryColumns_alloc(
+            sizeof(InventoryColumns));
+    
+    columns->inventory = inventory;
+    inventoryColumns_build(columns);
+    
+    return columns;
+}
+
+/**
+ * Method to bring columns up to date with their inventory, such as after
+ * sales have been made. Columns are rebuilt if stock items have been 
+ * added, removed or reordered, otherwise only the quantity and price 
+ * columns are refreshed. Or generates error message if memory allocation
+ * fails and terminates program.
+ * 
+ * @param Pointer to columns to be refreshed.
+ */
+void inventoryColumns_sync(InventoryColumns *columns) {
+    // Stock items held may since have been removed and freed, so they are
+    // not read
+    if (columns->modifications != columns->inventory->modifications) {
+        inventoryColumns_clear(columns);
+        inventoryColumns_build(columns);
+        return;
+    }
+    
+    for (int row = 0; row < columns->count; row++) {
+        columns->quantity[row] = stockItem_getQuantity(columns->items[row]);
+        columns->price[row]    = stockItem_getPennies(columns->items[row]);
+    }
+}
+
+/**
+ * Method to find all rows with a attribute of the given kind whose value 
+ * lies within a inclusive range and with at least the given quantity in 
+ * stock, such as capacitors between 10nF and 1uF with stock > 0.
+ * 
+ * @param  Pointer to columns to be scanned.
+ * @param  Kind of attribute to match.
+ * @param  Long minimum attribute value.
+ * @param  Long maximum attribute value.
+ * @param  Integer minimum quantity in stock.
+ * @param  Array where matching rows are stored, or null to only count 
+ *         them. Must fit inventoryColumns_count() rows.
+ * @return Integer number of matching rows.
+ */
+int inventoryColumns_findRange(const InventoryColumns *columns, 
+        AttributeKind kind, long long minValue, long long maxValue, 
+        int minQuantity, int *rows) {
+    int found = 0;
+    
+    for (int row = 0; row < columns->count; row++)
+        if ((columns->attributeKind[row] == kind) 
+                && (columns->attribute[row] >= minValue)
+                && (columns->attribute[row] <= maxValue)
+                && (columns->quantity[row] >= minQuantity)) {
+            if (rows)
+                rows[found] = row;
+            found++;
+        }
+    
+    return found;
+}
+
+/**
+ * Method to free columns from memory.
+ * 
+ * @param Pointer to columns to which will be freed from memory.
+ */
+void inventoryColumns_free(InventoryColumns *columns) {
+    inventoryColumns_clear(columns);
+    free(columns);
+}
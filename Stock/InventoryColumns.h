@@ -0,0 +1,185 @@
+/* 
+ * File:   InventoryColumns.h
+ * Author: Paulo Jorge
+ */
+
+#ifndef INVENTORYCOLUMNS_H
+#define INVENTORYCOLUMNS_H
+
+#include "StockItem.h"
+#include "Inventory.h"
+#include "ComponentType.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Columnar copy of a inventory, storing each stock item field in its own 
+ * contiguous array so scans over the whole catalog only touch the fields 
+ * they need. Row i of every column belongs to the same stock item, rows are
+ * in inventory order. IDs and descriptions are stored as offsets into a 
+ * single string table.
+ * 
+ * The copy is kept in step with its inventory by inventoryColumns_sync(),
+ * which rebuilds every column if stock items have been added, removed or 
+ * reordered since it was built, detected by the inventory's modification
+ * count, and otherwise only refreshes quantities and prices.
+ */
+typedef struct InventoryColumnsStruct {
+    const Inventory *inventory;
+    // Modification count of inventory when columns were built
+    unsigned long modifications;
+    int count;
+    StockItem **items;
+    int *quantity;
+    Money *price;
+    unsigned char *type, *attributeKind;
+    long long *attribute;
+    size_t *ID, *desc;
+    char *strings;
+}
+InventoryColumns;
+
+/**
+ * Method to get the number of rows in a columnar inventory.
+ * 
+ * @param  Pointer to columns to be checked.
+ * @return Integer number of stock items.
+ */
+static inline int inventoryColumns_count(const InventoryColumns *columns) {
+    return columns->count;
+}
+
+/**
+ * Method to get the quantity column of a columnar inventory.
+ * 
+ * @param  Pointer to columns containing quantities.
+ * @return Array of quantities in stock, one per row.
+ */
+static inline const int *inventoryColumns_quantities
+    (const InventoryColumns *columns) {
+    return columns->quantity;
+}
+
+/**
+ * Method to get the price column of a columnar inventory.
+ * 
+ * @param  Pointer to columns containing prices.
+ * @return Array of prices in pennies, one per row.
+ */
+static inline const Money *inventoryColumns_prices
+    (const InventoryColumns *columns) {
+    return columns->price;
+}
+
+/**
+ * Method to get the type code column of a columnar inventory.
+ * 
+ * @param  Pointer to columns containing type codes.
+ * @return Array of interned type codes, one per row.
+ */
+static inline const unsigned char *inventoryColumns_types
+    (const InventoryColumns *columns) {
+    return columns->type;
+}
+
+/**
+ * Method to get the attribute kind column of a columnar inventory.
+ * 
+ * @param  Pointer to columns containing attribute kinds.
+ * @return Array of AttributeKind values, one per row.
+ */
+static inline const unsigned char *inventoryColumns_attributeKinds
+    (const InventoryColumns *columns) {
+    return columns->attributeKind;
+}
+
+/**
+ * Method to get the attribute value column of a columnar inventory, such 
+ * as resistance in milliohms or capacitance in picofarads depending on the 
+ * attribute kind of each row.
+ * 
+ * @param  Pointer to columns containing attributes.
+ * @return Array of parsed description attribute values, one per row.
+ */
+static inline const long long *inventoryColumns_attributes
+    (const InventoryColumns *columns) {
+    return columns->attribute;
+}
+
+/**
+ * Method to get the ID of a row in a columnar inventory.
+ * 
+ * @param  Pointer to columns containing ID.
+ * @param  Integer row.
+ * @return ID char.
+ */
+static inline const char *inventoryColumns_getID
+    (const InventoryColumns *columns, int row) {
+    return columns->strings + columns->ID[row];
+}
+
+/**
+ * Method to get the description of a row in a columnar inventory.
+ * 
+ * @param  Pointer to columns containing description.
+ * @param  Integer row.
+ * @return Description char.
+ */
+static inline const char *inventoryColumns_getDesc
+    (const InventoryColumns *columns, int row) {
+    return columns->strings + columns->desc[row];
+}
+
+/**
+ * Method to build a columnar copy of a inventory. Or generates error 
+ * message if memory allocation fails and terminates program.
+ * 
+ * @param  Pointer to inventory to be copied.
+ * @return Pointer to newly created columns.
+ */
+InventoryColumns* inventoryColumns_new(const Inventory *inventory);
+
+/**
+ * Method to bring columns up to date with their inventory, such as after
+ * sales have been made. Columns are rebuilt if stock items have been 
+ * added, removed or reordered, otherwise only the quantity and price 
+ * columns are refreshed. Or generates error message if memory allocation
+ * fails and terminates program.
+ * 
+ * @param Pointer to columns to be refreshed.
+ */
+void inventoryColumns_sync(InventoryColumns *columns);
+
+/**
+ * Method to find all rows with a attribute of the given kind whose value 
+ * lies within a inclusive range and with at least the given quantity in 
+ * stock, such as capacitors between 10nF and 1uF with stock > 0.
+ * 
+ * @param  Pointer to columns to be scanned.
+ * @param  Kind of attribute to match.
+ * @param  Long minimum attribute value.
+ * @param  Long maximum attribute value.
+ * @param  Integer minimum quantity in stock.
+ * @param  Array where matching rows are stored, or null to only count 
+ *         them. Must fit inventoryColumns_count() rows.
+ * @return Integer number of matching rows.
+ */
+int inventoryColumns_findRange(const InventoryColumns *columns, 
+        AttributeKind kind, long long minValue, long long maxValue, 
+        int minQuantity, int *rows);
+
+/**
+ * Method to free columns from memory.
+ * 
+ * @param Pointer to columns to which will be freed from memory.
+ */
+void inventoryColumns_free(InventoryColumns *columns);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INVENTORYCOLUMNS_H */
+
@@ -0,0 +1,377 @@
+/* 
+ * File:   InventoryView.c
+ * Author: Paulo Jorge
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sched.h>
+
+#include "InventoryView.h"
+
+/**
+ * Method to allocate a empty undo log page. Or generates error message if
+ * memory allocation fails and terminates program.
+ * 
+ * @return Pointer to newly allocated page.
+ */
+static InventoryViewPage *inventoryViews_newPage() {
+    InventoryViewPage *page =
+            (InventoryViewPage*)malloc(sizeof(InventoryViewPage));
+    // Null check memory allocation
+    if (!page) {
+        fprintf(stderr, "Error: Unable to allocate memory in "
+                "inventoryViews_newPage().\n");
+        exit(EXIT_FAILURE);
+    }
+
+    atomic_init(&page->next, NULL);
+    return page;
+}
+
+/**
+ * Method for the writer to append a entry to the undo log, published once
+ * written. Pages of a emptied log are reused. Or generates error message
+ * if memory allocation fails and terminates program.
+ * 
+ * @param Pointer to source of views.
+ * @param Integer item index, or -1 for a count of sales applied.
+ * @param Integer quantity or count of sales.
+ * @param Epoch entry is saved in.
+ */
+static void inventoryViews_log(InventoryViews *views, int index,
+        int quantity, unsigned int epoch) {
+    long logged = atomic_load_explicit(&views->logged, memory_order_relaxed);
+    int slot = (int)(logged % INVENTORY_VIEW_LOG_PAGE);
+
+    // Move on to next page when current page is full
+    if ((logged > 0) && (slot == 0)) {
+        InventoryViewPage *next = atomic_load_explicit(&views->last->next,
+                memory_order_relaxed);
+        if (!next) {
+            next = inventoryViews_newPage();
+            atomic_store_explicit(&views->last->next, next,
+                    memory_order_release);
+        }
+        views->last = next;
+    }
+
+    InventoryViewEntry *entry = &views->last->entries[slot];
+    entry->index    = index;
+    entry->quantity = quantity;
+    entry->epoch    = epoch;
+    atomic_store_explicit(&views->logged, logged + 1, memory_order_release);
+}
+
+/**
+ * Method for the writer to save the quantity of a stock item to the undo
+ * log the first time it is changed in a epoch.
+ * 
+ * @param Pointer to source of views.
+ * @param Pointer to stock item about to be changed.
+ * @param Epoch of change.
+ */
+static void inventoryViews_save(InventoryViews *views, const StockItem *item,
+        unsigned int epoch) {
+    int index = stockItem_getIndex(item);
+
+    // Grow epochs stock items were logged in to cover item index
+    if (index >= views->changedCapacity) {
+        int capacity = views->changedCapacity ? views->changedCapacity : 64;
+        while (capacity <= index)
+            capacity *= 2;
+
+        unsigned int *changed = (unsigned int*)realloc(views->changed,
+                sizeof(unsigned int) * capacity);
+        // Null check memory allocation
+        if (!changed) {
+            fprintf(stderr, "Error: Unable to allocate memory in "
+                    "inventoryViews_save().\n");
+            exit(EXIT_FAILURE);
+        }
+        for (int i = views->changedCapacity; i < capacity; i++)
+            changed[i] = 0;
+        views->changed         = changed;
+        views->changedCapacity = capacity;
+    }
+
+    if (views->changed[index] != epoch) {
+        inventoryViews_log(views, index, stockItem_getQuantity(item), epoch);
+        views->changed[index] = epoch;
+    }
+}
+
+/**
+ * Method for the writer to keep sales records replaced while views were
+ * live, until none are. Or generates error message if memory allocation
+ * fails and terminates program.
+ * 
+ * @param Pointer to source of views.
+ * @param Pointer to sales records replaced.
+ */
+static void inventoryViews_retire(InventoryViews *views,
+        SalesRecord *records) {
+    if (views->retiredCount == views->retiredCapacity) {
+        int capacity = views->retiredCapacity ? views->retiredCapacity * 2
+                : 8;
+        SalesRecord **retired = (SalesRecord**)realloc(views->retired,
+                sizeof(SalesRecord*) * capacity);
+        // Null check memory allocation
+        if (!retired) {
+            fprintf(stderr, "Error: Unable to allocate memory in "
+                    "inventoryViews_retire().\n");
+            exit(EXIT_FAILURE);
+        }
+        views->retired         = retired;
+        views->retiredCapacity = capacity;
+    }
+
+    views->retired[views->retiredCount++] = records;
+}
+
+/**
+ * Method for the writer to free sales records replaced while views were
+ * live, once none are.
+ * 
+ * @param Pointer to source of views.
+ */
+static void inventoryViews_freeRetired(InventoryViews *views) {
+    for (int i = 0; i < views->retiredCount; i++)
+        free(views->retired[i]);
+    views->retiredCount = 0;
+}
+
+/**
+ * Method to allocate memory for a new source of views of a inventory and
+ * its sales list. Or generates error message if memory allocation fails
+ * and terminates program.
+ * 
+ * @param  Pointer to inventory to be viewed.
+ * @param  Pointer to sales list sales are appended to.
+ * @return Pointer to newly created source of views.
+ */
+InventoryViews *inventoryViews_new(Inventory *inventory, Sales *sales) {
+    // Allocate source of views to memory
+    InventoryViews *views = (InventoryViews*)malloc(sizeof(InventoryViews));
+    // Null check memory allocation
+    if (!views) {
+        fprintf(stderr, "Error: Unable to allocate memory in "
+                "inventoryViews_new().\n");
+        exit(EXIT_FAILURE);
+    }
+
+    views->inventory = inventory;
+    views->sales     = sales;
+    atomic_init(&views->epoch, 1);
+    atomic_init(&views->activeEpoch, 0);
+    atomic_init(&views->pinning, 0);
+    atomic_init(&views->applied, sales_count(sales));
+    atomic_init(&views->records, sales->records);
+    atomic_init(&views->live, 0);
+
+    // Start with a empty undo log
+    views->first = inventoryViews_newPage();
+    views->last  = views->first;
+    atomic_init(&views->logged, 0);
+
+    views->changed         = NULL;
+    views->changedCapacity = 0;
+    views->lastEpoch       = 0;
+
+    views->retired         = NULL;
+    views->retiredCount    = 0;
+    views->retiredCapacity = 0;
+
+    return views;
+}
+
+/**
+ * Method for the writer thread to append a new sale to the sales list,
+ * as sales_add() does, keeping pinned views consistent. Or generates
+ * error message if memory allocation fails and terminates program.
+ * 
+ * @param  Pointer to source of views.
+ * @param  Date of sale.
+ * @param  Char ID of stock item sold.
+ * @param  Integer Quantity of number of items sold.
+ * @return 1 if sale was made or 0 if item was not found or has
+ *         insufficient stock.
+ */
+int inventoryViews_add(InventoryViews *views, Date date, const char *ID,
+        int quantity) {
+    StockItem *item = inventory_find(views->inventory, ID);
+
+    // Mark sale as in progress in current epoch, so a view pinned meanwhile
+    // waits for it instead of seeing it half applied
+    unsigned int epoch = atomic_load(&views->epoch);
+    for (;;) {
+        atomic_store(&views->activeEpoch, epoch);
+        unsigned int current = atomic_load(&views->epoch);
+        if (current == epoch)
+            break;
+        epoch = current;
+    }
+
+    // Records replaced while views were live can be freed once none are,
+    // as a view pinned from now on waits for this sale to finish
+    int live = atomic_load(&views->live);
+    if (live == 0)
+        inventoryViews_freeRetired(views);
+
+    // Only log while a view is being pinned, otherwise empty the log
+    if (atomic_load(&views->pinning) == 0) {
+        atomic_store_explicit(&views->logged, 0, memory_order_relaxed);
+        views->last = views->first;
+    }
+    else {
+        if (epoch != views->lastEpoch)
+            inventoryViews_log(views, -1, atomic_load_explicit(
+                    &views->applied, memory_order_relaxed), epoch);
+        if (item)
+            inventoryViews_save(views, item, epoch);
+    }
+    views->lastEpoch = epoch;
+
+    // Grow sales list into a new array, keeping old records while views
+    // may be reading them
+    if (item) {
+        SalesRecord *old = sales_reserveDetached(views->sales, 1);
+        if (old) {
+            if (live)
+                inventoryViews_retire(views, old);
+            else
+                free(old);
+            atomic_store_explicit(&views->records, views->sales->records,
+                    memory_order_release);
+        }
+    }
+
+    int made = item && sales_addItem(views->sales, item, date, quantity);
+    if (made)
+        atomic_fetch_add_explicit(&views->applied, 1, memory_order_release);
+
+    atomic_store(&views->activeEpoch, 0);
+    return made;
+}
+
+/**
+ * Method to pin a consistent view of the inventory and the number of
+ * sales applied, while the writer keeps applying sales. Or generates
+ * error message if memory allocation fails and terminates program.
+ * 
+ * @param  Pointer to source of views.
+ * @return Pointer to newly pinned view.
+ */
+InventoryView *inventoryView_pin(InventoryViews *views) {
+    // End current epoch, the view is of the state at its end
+    atomic_fetch_add(&views->live, 1);
+    atomic_fetch_add(&views->pinning, 1);
+    unsigned int epoch = atomic_fetch_add(&views->epoch, 1);
+
+    // Wait for a sale in progress in this or a earlier epoch to finish
+    for (unsigned int active; ((active = atomic_load(&views->activeEpoch))
+            != 0) && (active <= epoch); )
+        sched_yield();
+
+    int count = inventory_itemCount(views->inventory);
+    InventoryView *view = (InventoryView*)malloc(sizeof(InventoryView));
+    int *quantities = (int*)malloc(sizeof(int) * (count ? count : 1));
+    unsigned char *restored = (unsigned char*)calloc(count ? count : 1, 1);
+    // Null check memory allocation
+    if (!view || !quantities || !restored) {
+        fprintf(stderr, "Error: Unable to allocate memory in "
+                "inventoryView_pin().\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // Copy current quantities, then sales applied and length of undo log
+    for (int i = 0; i < count; i++) {
+        StockItem *item = inventory_getItem(views->inventory, i);
+        quantities[i] = item ? atomic_load_explicit(&item->quantity,
+                memory_order_acquire) : 0;
+    }
+    int salesCount = atomic_load_explicit(&views->applied,
+            memory_order_acquire);
+    // Records are loaded after count, so they hold every sale counted
+    const SalesRecord *records = atomic_load_explicit(&views->records,
+            memory_order_acquire);
+    long logged = atomic_load_explicit(&views->logged, memory_order_acquire);
+
+    // Put back quantities saved after view's epoch, the first saved of
+    // each stock item being its quantity at the end of the epoch
+    int counted = 0;
+    InventoryViewPage *page = views->first;
+    for (long i = 0; i < logged; i++) {
+        if ((i > 0) && (i % INVENTORY_VIEW_LOG_PAGE == 0))
+            page = atomic_load_explicit(&page->next, memory_order_acquire);
+
+        const InventoryViewEntry *entry =
+                &page->entries[i % INVENTORY_VIEW_LOG_PAGE];
+        if (entry->epoch <= epoch)
+            continue;
+        if (entry->index < 0) {
+            if (!counted)
+                salesCount = entry->quantity;
+            counted = 1;
+        }
+        else if ((entry->index < count) && !restored[entry->index]) {
+            quantities[entry->index] = entry->quantity;
+            restored[entry->index] = 1;
+        }
+    }
+    atomic_fetch_sub(&views->pinning, 1);
+
+    // Copy stock items in inventory order with their viewed quantities,
+    // all taken at once from the view inventory's arena
+    view->views      = views;
+    view->inventory  = inventory_new();
+    view->sales      = records;
+    view->salesCount = salesCount;
+    StockItem *copies = (StockItem*)arena_alloc(
+            inventory_getArena(view->inventory),
+            sizeof(StockItem) * (count ? count : 1));
+    int copied = 0;
+    for (InventoryIterator i = inventory_first(views->inventory); i != NULL;
+            i = inventory_iteratorNext(i))
+        inventory_add(view->inventory, stockItem_initCopy(&copies[copied++],
+                i->item, quantities[stockItem_getIndex(i->item)]));
+
+    free(quantities);
+    free(restored);
+    return view;
+}
+
+/**
+ * Method to release a view, freeing it and its copies of stock items from
+ * memory.
+ * 
+ * @param Pointer to view to be released.
+ */
+void inventoryView_release(InventoryView *view) {
+    // Copies are in the inventory's arena, so are freed along with it
+    inventory_free(view->inventory);
+    atomic_fetch_sub(&view->views->live, 1);
+    free(view);
+}
+
+/**
+ * Method to free a source of views from memory, once all its views have
+ * been released.
+ * 
+ * @param Pointer to source of views to be freed.
+ */
+void inventoryViews_free(InventoryViews *views) {
+    InventoryViewPage *page = views->first;
+    while (page) {
+        InventoryViewPage *next = atomic_load(&page->next);
+        free(page);
+        page = next;
+    }
+
+    inventoryViews_freeRetired(views);
+    free(views->retired);
+    free(views->changed);
+    free(views);
+}
@@ -0,0 +1,200 @@
+/* 
+ * File:   InventoryView.h
+ * Author: Paulo Jorge
+ */
+
+#ifndef INVENTORYVIEW_H
+#define INVENTORYVIEW_H
+
+#include <stdatomic.h>
+
+#include "StockItem.h"
+#include "Inventory.h"
+#include "Sales.h"
+#include "Date.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Number of entries in each page of a undo log.
+ */
+#define INVENTORY_VIEW_LOG_PAGE 4096
+
+/**
+ * Entry of a undo log, holding the quantity of a stock item before it was
+ * first changed in a epoch. Entries with a item index of -1 hold the
+ * number of sales applied before the epoch instead.
+ */
+typedef struct InventoryViewEntryStruct {
+    int index, quantity;
+    unsigned int epoch;
+}
+InventoryViewEntry;
+
+/**
+ * Page of a undo log. Pages are never moved once written, so readers can
+ * walk them while the writer appends.
+ */
+typedef struct InventoryViewPageStruct {
+    InventoryViewEntry entries[INVENTORY_VIEW_LOG_PAGE];
+    struct InventoryViewPageStruct *_Atomic next;
+}
+InventoryViewPage;
+
+/**
+ * Source of consistent views of a inventory and its sales while a single
+ * writer thread applies sales with inventoryViews_add().
+ * 
+ * Pinning a view ends the current epoch. The writer saves the quantity of
+ * a stock item to a undo log the first time it changes it in each later
+ * epoch, so a reader copies current quantities and puts back the saved
+ * quantity of every stock item changed since its epoch. Neither side
+ * waits for the other, except a reader waits for a sale already in
+ * progress when it pins. Nothing is logged while no view is being
+ * pinned, as a pinned view is a copy that needs no further logging.
+ * 
+ * Views read sales records in place. While any view is pinned the writer
+ * grows the sales list into a new array instead of reallocating it, and
+ * keeps the arrays it replaces until every view has been released, so a
+ * view's records stay valid for as long as it does.
+ * 
+ * Stock items must not be added to or removed from the inventory while
+ * views are in use.
+ */
+typedef struct InventoryViewsStruct {
+    Inventory *inventory;
+    Sales *sales;
+    // Current epoch, epoch of sale in progress or 0, and number of views
+    // being pinned
+    atomic_uint epoch, activeEpoch;
+    atomic_int pinning;
+    // Number of sales applied
+    atomic_int applied;
+    // Sales records views read, and number of views pinned or being
+    // pinned and not yet released
+    SalesRecord *_Atomic records;
+    atomic_int live;
+    // Undo log pages, first page is kept when log is emptied
+    InventoryViewPage *first, *last;
+    atomic_long logged;
+    // Used by writer only, epoch each stock item was last logged in by
+    // item index and epoch of last sale
+    unsigned int *changed;
+    int changedCapacity;
+    unsigned int lastEpoch;
+    // Used by writer only, sales records replaced while views were live
+    SalesRecord **retired;
+    int retiredCount, retiredCapacity;
+}
+InventoryViews;
+
+/**
+ * Consistent view of a inventory pinned by inventoryView_pin(). Its
+ * inventory holds copies of every stock item with the quantities they had
+ * after the first salesCount sales, and can be sorted, printed and
+ * aggregated like any other inventory. Those sales are the first 
+ * salesCount of its sales records.
+ */
+typedef struct InventoryViewStruct {
+    InventoryViews *views;
+    Inventory *inventory;
+    const SalesRecord *sales;
+    int salesCount;
+}
+InventoryView;
+
+/**
+ * Method to allocate memory for a new source of views of a inventory and
+ * its sales list. Or generates error message if memory allocation fails
+ * and terminates program.
+ * 
+ * @param  Pointer to inventory to be viewed.
+ * @param  Pointer to sales list sales are appended to.
+ * @return Pointer to newly created source of views.
+ */
+InventoryViews *inventoryViews_new(Inventory *inventory, Sales *sales);
+
+/**
+ * Method for the writer thread to append a new sale to the sales list,
+ * as sales_add() does, keeping pinned views consistent. Or generates
+ * error message if memory allocation fails and terminates program.
+ * 
+ * @param  Pointer to source of views.
+ * @param  Date of sale.
+ * @param  Char ID of stock item sold.
+ * @param  Integer Quantity of number of items sold.
+ * @return 1 if sale was made or 0 if item was not found or has
+ *         insufficient stock.
+ */
+int inventoryViews_add(InventoryViews *views, Date date, const char *ID,
+        int quantity);
+
+/**
+ * Method to pin a consistent view of the inventory and the number of
+ * sales applied, while the writer keeps applying sales. Or generates
+ * error message if memory allocation fails and terminates program.
+ * 
+ * @param  Pointer to source of views.
+ * @return Pointer to newly pinned view.
+ */
+InventoryView *inventoryView_pin(InventoryViews *views);
+
+/**
+ * Get method to get the inventory of a view, holding copies of the stock
+ * items with their quantities at the time the view was pinned.
+ * 
+ * @param  Pointer to view.
+ * @return Pointer to inventory of view.
+ */
+static inline Inventory *inventoryView_inventory(const InventoryView *view) {
+    return view->inventory;
+}
+
+/**
+ * Get method to get the number of sales applied at the time a view was
+ * pinned.
+ * 
+ * @param  Pointer to view.
+ * @return Integer number of sales.
+ */
+static inline int inventoryView_salesCount(const InventoryView *view) {
+    return view->salesCount;
+}
+
+/**
+ * Get method to get the sales records of a view, the first salesCount of
+ * which are the sales applied at the time it was pinned. They stay valid
+ * until the view is released, however many sales are applied meanwhile,
+ * but records past salesCount must not be read.
+ * 
+ * @param  Pointer to view.
+ * @return Pointer to first sales record of view.
+ */
+static inline const SalesRecord *inventoryView_sales(
+        const InventoryView *view) {
+    return view->sales;
+}
+
+/**
+ * Method to release a view, freeing it and its copies of stock items from
+ * memory.
+ * 
+ * @param Pointer to view to be released.
+ */
+void inventoryView_release(InventoryView *view);
+
+/**
+ * Method to free a source of views from memory, once all its views have
+ * been released.
+ * 
+ * @param Pointer to source of views to be freed.
+ */
+void inventoryViews_free(InventoryViews *views);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INVENTORYVIEW_H */
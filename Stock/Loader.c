@@ -0,0 +1,969 @@
+/* 
+ * File:   Loader.c
+ * Author: Paulo Jorge
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <pthread.h>
+#include <sched.h>
+#include <errno.h>
+#include <stdatomic.h>
+#include <time.h>
+
+#include "Loader.h"
+#include "StockItem.h"
+#include "Date.h"
+
+// Buffer size for type names, which are interned so only need to be local
+#define LOADER_TYPE_BUFFER 32
+
+// Initial number of sales records allocated per chunk
+#define LOADER_CHUNK_RECORDS 1024
+
+// Size and number of blocks read by a pipelined load
+#define LOADER_PIPELINE_BLOCK (1 << 20)
+#define LOADER_PIPELINE_BLOCKS 4
+// Number of records per batch parsed by a pipelined load, and of batches
+#define LOADER_PIPELINE_RECORDS 4096
+#define LOADER_PIPELINE_BATCHES 8
+// Slots of each pipeline queue, enough to hold every block or batch and
+// the end of stream marker
+#define LOADER_PIPELINE_QUEUE 16
+
+/**
+ * Structure holding the fields of a parsed sales line.
+ */
+typedef struct LoaderSaleStruct {
+    Date date;
+    int quantity;
+    const char *ID;
+    size_t IDLength;
+}
+LoaderSale;
+
+/**
+ * Structure holding a sale parsed by a parallel load, waiting to be 
+ * applied. Lines that could not be used keep a null stock item, with the 
+ * line number within the chunk in place of the quantity when malformed.
+ */
+typedef struct LoaderRecordStruct {
+    StockItem *item;
+    Date date;
+    int quantity;
+    int malformed;
+}
+LoaderRecord;
+
+/**
+ * Structure defining a chunk of a file parsed by one thread.
+ */
+typedef struct LoaderChunkStruct {
+    const char *start, *end;
+    const Inventory *inventory;
+    LoaderRecord *records;
+    int count, capacity, lines;
+}
+LoaderChunk;
+
+/**
+ * Structure defining a bounded queue joining two stages of a pipelined 
+ * load, with a single producer and a single consumer.
+ */
+typedef struct LoaderQueueStruct {
+    void *slots[LOADER_PIPELINE_QUEUE];
+    // Next slot to pop and to push, on separate cache lines
+    _Alignas(64) atomic_size_t head;
+    _Alignas(64) atomic_size_t tail;
+}
+LoaderQueue;
+
+/**
+ * Structure defining a block of a file read by a pipelined load, ending 
+ * after a newline unless it is the last.
+ */
+typedef struct LoaderBlockStruct {
+    char *data;
+    size_t size, capacity;
+}
+LoaderBlock;
+
+/**
+ * Structure defining a batch of records parsed by a pipelined load.
+ */
+typedef struct LoaderBatchStruct {
+    LoaderRecord records[LOADER_PIPELINE_RECORDS];
+    int count;
+}
+LoaderBatch;
+
+/**
+ * Structure defining a pipelined load. Blocks pass from the free queue to
+ * the read stage, through the full queue to the parse stage and back, and
+ * batches from the parse stage to the apply stage and back likewise.
+ */
+typedef struct LoaderPipelineStruct {
+    int descriptor;
+    const char *fileName;
+    const Inventory *inventory;
+    LoaderQueue freeBlocks, fullBlocks, freeBatches, fullBatches;
+    LoaderBlock blocks[LOADER_PIPELINE_BLOCKS];
+    LoaderPipelineStats stats;
+}
+LoaderPipeline;
+
+/**
+ * Method to map a whole file into memory for reading, if it can be.
+ * 
+ * @param  Pointer to mapping to be filled in, left empty on failure.
+ * @param  File name of file to be mapped.
+ * @return 1 if file was mapped or 0 if it could not be opened or mapped.
+ */
+int mappedFile_tryOpen(MappedFile *file, const char *fileName) {
+    int descriptor = open(fileName, O_RDONLY);
+    struct stat status;
+    
+    file->size = 0;
+    file->data = NULL;
+    
+    // Check file has correctly opened
+    if (descriptor < 0)
+        return 0;
+    if (fstat(descriptor, &status) != 0) {
+        close(descriptor);
+        return 0;
+    }
+    
+    // Empty files can not be mapped but need no data
+    if (status.st_size > 0) {
+        void *data = mmap(NULL, (size_t)status.st_size, PROT_READ, 
+                MAP_PRIVATE, descriptor, 0);
+        if (data == MAP_FAILED) {
+            close(descriptor);
+            return 0;
+        }
+        // File is read once from start to end
+        posix_madvise(data, (size_t)status.st_size, POSIX_MADV_SEQUENTIAL);
+        file->data = (const char*)data;
+        file->size = (size_t)status.st_size;
+    }
+    
+    // Mapping stays valid once descriptor is closed
+    close(descriptor);
+    return 1;
+}
+
+/**
+ * Method to map a whole file into memory for reading. Or generates error 
+ * message if file can not be opened or mapped and terminates program.
+ * 
+ * @param  Pointer to mapping to be filled in.
+ * @param  File name of file to be mapped.
+ */
+void mappedFile_open(MappedFile *file, const char *fileName) {
+    if (!mappedFile_tryOpen(file, fileName)) {
+        fprintf(stderr, "Error: Unable to open '%s' for reading "
+                "in mappedFile_open().\n", fileName);
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * Method to unmap a file mapped by mappedFile_open().
+ * 
+ * @param Pointer to mapping to be closed.
+ */
+void mappedFile_close(MappedFile *file) {
+    if (file->data)
+        munmap((void*)file->data, file->size);
+    file->data = NULL;
+    file->size = 0;
+}
+
+/**
+ * Method to skip spaces and tabs.
+ * 
+ * @param  Pointer to current position.
+ * @param  Pointer to end of line.
+ * @return Pointer to first char that is not a space or tab.
+ */
+static inline const char *loader_skipSpaces(const char *p, const char *end) {
+    while ((p < end) && ((*p == ' ') || (*p == '\t')))
+        p++;
+    return p;
+}
+
+/**
+ * Method to parse a unsigned decimal integer.
+ * 
+ * @param  Pointer to current position.
+ * @param  Pointer to end of line.
+ * @param  Pointer to where integer will be stored.
+ * @return Pointer to first char after integer, or null if there are no 
+ *         digits or the integer is greater than INT_MAX.
+ */
+static inline const char *loader_parseInt(const char *p, const char *end, 
+        int *value) {
+    const char *start = p;
+    int result = 0;
+    
+    while ((p < end) && (*p >= '0') && (*p <= '9')) {
+        int digit = *p++ - '0';
+        if (result > (INT_MAX - digit) / 10) {
+            start = p;
+            break;
+        }
+        result = result * 10 + digit;
+    }
+    
+    *value = result;
+    return (p == start) ? NULL : p;
+}
+
+/**
+ * Method to find the end of a line, excluding any trailing carriage return.
+ * 
+ * @param  Pointer to start of line.
+ * @param  Pointer to end of file.
+ * @param  Pointer to where start of next line will be stored.
+ * @return Pointer to end of line contents.
+ */
+static inline const char *loader_lineEnd(const char *p, const char *end, 
+        const char **next) {
+    const char *newline = (const char*)memchr(p, '\n', end - p);
+    const char *lineEnd = newline ? newline : end;
+    
+    *next = newline ? newline + 1 : end;
+    if ((lineEnd > p) && (lineEnd[-1] == '\r'))
+        lineEnd--;
+    
+    return lineEnd;
+}
+
+/**
+ * Method to read the next comma separated field of a line, trimming spaces
+ * and tabs around it.
+ * 
+ * @param  Pointer to current position.
+ * @param  Pointer to end of line.
+ * @param  Pointer to where start of field will be stored.
+ * @param  Pointer to where length of field will be stored.
+ * @return Pointer to the char after the field separator.
+ */
+static const char *loader_field(const char *p, const char *end, 
+        const char **field, size_t *length) {
+    p = loader_skipSpaces(p, end);
+    const char *comma = (p < end) 
+            ? (const char*)memchr(p, ',', end - p) : NULL;
+    const char *fieldEnd = comma ? comma : end;
+    
+    *field = p;
+    while ((fieldEnd > p) && ((fieldEnd[-1] == ' ') || (fieldEnd[-1] == '\t')))
+        fieldEnd--;
+    *length = fieldEnd - p;
+    
+    return comma ? comma + 1 : end;
+}
+
+/**
+ * Method to parse a integer field, which must contain only digits.
+ * 
+ * @param  Pointer to field.
+ * @param  Length of field.
+ * @param  Pointer to where integer will be stored.
+ * @return 1 if field was parsed or 0 if not.
+ */
+static int loader_intField(const char *field, size_t length, int *value) {
+    const char *end = loader_parseInt(field, field + length, value);
+    return end == field + length;
+}
+
+/**
+ * Method to read stock items from a file and add each one into a 
+ * existing inventory. The file is memory mapped and scanned in place, each
+ * stock item and its ID and description taken from the inventory's arena 
+ * in one piece, so they are freed with the inventory. Or generates error
+ * message if file can not be read or contains a duplicate ID and 
+ * terminates program.
+ * 
+ * @param Pointer to inventory where all stock items will be added to.
+ * @param File name of file to be read. 
+ */
+void loader_readInventory(Inventory* inventory, const char *fileName) {
+    MappedFile file;
+    mappedFile_open(&file, fileName);
+    
+    const char *p = file.data, *end = file.data + file.size, *next;
+    int lineNumber = 0;
+    
+    // Loop each line in file
+    for (; p < end; p = next) {
+        const char *lineEnd = loader_lineEnd(p, end, &next);
+        lineNumber++;
+        
+        // Skip blank lines
+        if (loader_skipSpaces(p, lineEnd) == lineEnd)
+            continue;
+        
+        // Split line into fields, description is optional
+        const char *type, *ID, *quantityField, *priceField, *descField;
+        size_t typeLength, IDLength, quantityLength, priceLength, descLength;
+        int quantity, price;
+        p = loader_field(p, lineEnd, &type, &typeLength);
+        p = loader_field(p, lineEnd, &ID, &IDLength);
+        p = loader_field(p, lineEnd, &quantityField, &quantityLength);
+        p = loader_field(p, lineEnd, &priceField, &priceLength);
+        p = loader_field(p, lineEnd, &descField, &descLength);
+        
+        // Output error and exit if line is malformed
+        if ((typeLength == 0) || (typeLength >= LOADER_TYPE_BUFFER) 
+                || (IDLength == 0)
+                || !loader_intField(quantityField, quantityLength, &quantity)
+                || !loader_intField(priceField, priceLength, &price)) {
+            fprintf(stderr, "Error: Malformed line %d in '%s' "
+                    "in loader_readInventory().\n", lineNumber, fileName);
+            exit(EXIT_FAILURE);
+        }
+        
+        // Copy type to a local buffer so it can be interned
+        char typeName[LOADER_TYPE_BUFFER];
+        memcpy(typeName, type, typeLength);
+        typeName[typeLength] = '\0';
+        
+        // Allocate stock item with its ID and description from inventory's
+        // arena, sized to fit
+        char *memory = (char*)arena_alloc(inventory_getArena(inventory), 
+                sizeof(StockItem) + IDLength + descLength + 2);
+        char *strings = memory + sizeof(StockItem);
+        memcpy(strings, ID, IDLength);
+        strings[IDLength] = '\0';
+        char *desc = strings + IDLength + 1;
+        memcpy(desc, descField, descLength);
+        desc[descLength] = '\0';
+        
+        // Create new stock item, items without a description show N/A
+        StockItem *item = stockItem_init((StockItem*)memory, typeName, 
+                strings, quantity, price, (descLength > 0) ? desc : NULL);
+        
+        // Add stock item to inventory, a duplicate ID means the file is 
+        // corrupt so output error and exit program
+        if (!inventory_add(inventory, item)) {
+            fprintf(stderr, "Error: Duplicate stock item ID '%s' in '%s' "
+                    "in loader_readInventory().\n", strings, fileName);
+            exit(EXIT_FAILURE);
+        }
+    }
+    
+    mappedFile_close(&file);
+}
+
+/**
+ * Method to parse a sales line in the form "DD/MM/YYYY, ID,quantity". 
+ * Dates without leading 0's, such as "9/10/2017", are also accepted.
+ * 
+ * @param  Pointer to start of line.
+ * @param  Pointer to end of line.
+ * @param  Pointer to sale where parsed fields will be stored, the ID is
+ *         left as a slice of the line.
+ * @return 1 if line was parsed or 0 if it is malformed or has a invalid
+ *         date.
+ */
+static int loader_parseSale(const char *p, const char *lineEnd, 
+        LoaderSale *sale) {
+    // Parse date, using fixed width form when line has one
+    if ((lineEnd - p >= 10) 
+            && ((sale->date = date_parse(p)) != DATE_NONE))
+        p += 10;
+    else {
+        int day, month, year;
+        if (!(p = loader_parseInt(p, lineEnd, &day)) || (p == lineEnd) 
+                || (*p++ != '/')
+                || !(p = loader_parseInt(p, lineEnd, &month)) 
+                || (p == lineEnd) || (*p++ != '/')
+                || !(p = loader_parseInt(p, lineEnd, &year))
+                || ((sale->date = date_fromDMY(day, month, year)) 
+                    == DATE_NONE))
+            return 0;
+    }
+    
+    // Parse ID, up to the next comma or space
+    p = loader_skipSpaces(p, lineEnd);
+    if ((p == lineEnd) || (*p++ != ','))
+        return 0;
+    p = sale->ID = loader_skipSpaces(p, lineEnd);
+    while ((p < lineEnd) && (*p != ',') && (*p != ' ') && (*p != '\t'))
+        p++;
+    sale->IDLength = p - sale->ID;
+    
+    // Parse quantity, which must end the line
+    p = loader_skipSpaces(p, lineEnd);
+    if ((sale->IDLength == 0) || (p == lineEnd) || (*p++ != ','))
+        return 0;
+    p = loader_parseInt(loader_skipSpaces(p, lineEnd), lineEnd, 
+            &sale->quantity);
+    
+    return p && (loader_skipSpaces(p, lineEnd) == lineEnd);
+}
+
+/**
+ * Method to read sales from a file and add each one into a existing sales
+ * list. The file is memory mapped and scanned in place, dates and 
+ * quantities are parsed directly and IDs are looked up as slices of the 
+ * mapping, so no field is copied. Malformed lines are reported and 
+ * skipped. Or generates error message if file can not be read and 
+ * terminates program.
+ * 
+ * @param Pointer to sales list where all sales will be added to.
+ * @param Pointer to inventory containing stock items sold.
+ * @param File name of file to be read. 
+ */
+void loader_readSales(Sales* sales, Inventory* inventory, 
+        const char *fileName) {
+    MappedFile file;
+    mappedFile_open(&file, fileName);
+    
+    const char *p = file.data, *end = file.data + file.size, *next;
+    int lineNumber = 0;
+    
+    // Loop each line in file
+    for (; p < end; p = next) {
+        const char *lineEnd = loader_lineEnd(p, end, &next);
+        LoaderSale sale;
+        lineNumber++;
+        
+        // Skip blank lines
+        p = loader_skipSpaces(p, lineEnd);
+        if (p == lineEnd)
+            continue;
+        
+        // Report and skip malformed lines
+        if (!loader_parseSale(p, lineEnd, &sale)) {
+            fprintf(stderr, "Error: Malformed line %d in '%s' "
+                    "in loader_readSales().\n", lineNumber, fileName);
+            continue;
+        }
+        
+        // Add this sale to sales list if stock item exists
+        StockItem *item = inventory_findSlice(inventory, sale.ID, 
+                sale.IDLength);
+        if (item)
+            sales_addItem(sales, item, sale.date, sale.quantity);
+    }
+    
+    mappedFile_close(&file);
+}
+
+/**
+ * Method to get the current time in seconds, used for phase timings.
+ * 
+ * @return Current time in seconds.
+ */
+static double loader_now() {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    
+    return time.tv_sec + (time.tv_nsec / 1e9);
+}
+
+/**
+ * Method to append a record to a chunk, growing its records as needed. Or
+ * generates error message if memory allocation fails and terminates 
+ * program.
+ * 
+ * @param  Pointer to chunk.
+ * @return Pointer to new record.
+ */
+static LoaderRecord *loader_chunkAppend(LoaderChunk *chunk) {
+    if (chunk->count == chunk->capacity) {
+        chunk->capacity = chunk->capacity ? chunk->capacity * 2 
+                : LOADER_CHUNK_RECORDS;
+        chunk->records = (LoaderRecord*)realloc(chunk->records, 
+                sizeof(LoaderRecord) * chunk->capacity);
+        // Null check memory allocation
+        if (!chunk->records) {
+            fprintf(stderr, "Error: Unable to allocate memory in "
+                    "loader_chunkAppend().\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    
+    return &chunk->records[chunk->count++];
+}
+
+/**
+ * Method to parse a sales line into a record, resolving its ID against 
+ * the inventory, which is only read.
+ * 
+ * @param Pointer to start of line, after any leading spaces.
+ * @param Pointer to end of line.
+ * @param Pointer to inventory containing stock items sold.
+ * @param Integer line number, kept in place of the quantity when 
+ *        malformed so the error can be reported in file order.
+ * @param Pointer to record to be filled in.
+ */
+static void loader_parseRecord(const char *p, const char *lineEnd, 
+        const Inventory *inventory, int lineNumber, LoaderRecord *record) {
+    LoaderSale sale;
+    
+    if (loader_parseSale(p, lineEnd, &sale)) {
+        record->item      = inventory_findSlice(inventory, sale.ID, 
+                sale.IDLength);
+        record->date      = sale.date;
+        record->quantity  = sale.quantity;
+        record->malformed = 0;
+    } else {
+        record->item      = NULL;
+        record->quantity  = lineNumber;
+        record->malformed = 1;
+    }
+}
+
+/**
+ * Thread method to parse every line of a chunk into records, resolving 
+ * IDs against the inventory, which is only read.
+ * 
+ * @param  Pointer to chunk to be parsed.
+ * @return Null.
+ */
+static void *loader_parseChunk(void *argument) {
+    LoaderChunk *chunk = (LoaderChunk*)argument;
+    const char *p = chunk->start, *next;
+    
+    for (; p < chunk->end; p = next) {
+        const char *lineEnd = loader_lineEnd(p, chunk->end, &next);
+        chunk->lines++;
+        
+        // Skip blank lines
+        p = loader_skipSpaces(p, lineEnd);
+        if (p == lineEnd)
+            continue;
+        
+        loader_parseRecord(p, lineEnd, chunk->inventory, chunk->lines, 
+                loader_chunkAppend(chunk));
+    }
+    
+    return NULL;
+}
+
+/**
+ * Method to read sales from a file using several threads. The mapped file
+ * is split into chunks at line boundaries which are parsed in parallel, 
+ * resolving IDs to stock items, then the sales are applied to the 
+ * inventory in original file order so sales rejected for insufficient 
+ * stock are exactly those rejected by loader_readSales(). Or generates 
+ * error message if file can not be read or a thread can not be started
+ * and terminates program.
+ * 
+ * @param Pointer to sales list where all sales will be added to.
+ * @param Pointer to inventory containing stock items sold.
+ * @param File name of file to be read. 
+ * @param Integer number of parse threads, or 0 for one per processor.
+ * @param Pointer to where phase timings will be stored, or null.
+ */
+void loader_readSalesParallel(Sales* sales, Inventory* inventory, 
+        const char *fileName, int threads, LoaderTimings *timings) {
+    double start = loader_now();
+    MappedFile file;
+    mappedFile_open(&file, fileName);
+    double mapped = loader_now();
+    
+    // Default to one thread per processor
+    if (threads <= 0)
+        threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (threads <= 0)
+        threads = 1;
+    
+    LoaderChunk *chunks = (LoaderChunk*)calloc(threads, sizeof(LoaderChunk));
+    pthread_t *workers = (pthread_t*)malloc(sizeof(pthread_t) * threads);
+    // Null check memory allocation
+    if (!chunks || !workers) {
+        fprintf(stderr, "Error: Unable to allocate memory in "
+                "loader_readSalesParallel().\n");
+        exit(EXIT_FAILURE);
+    }
+    
+    // Split file into chunks of roughly equal size, each chunk ending 
+    // after a newline so no line is split
+    const char *end = file.data + file.size, *p = file.data;
+    for (int i = 0; i < threads; i++) {
+        const char *chunkEnd = (i == threads - 1) ? end 
+                : file.data + file.size / threads * (i + 1);
+        if (chunkEnd < p)
+            chunkEnd = p;
+        if (chunkEnd < end) {
+            const char *newline = (const char*)memchr(chunkEnd, '\n', 
+                    end - chunkEnd);
+            chunkEnd = newline ? newline + 1 : end;
+        }
+        
+        chunks[i].start     = p;
+        chunks[i].end       = chunkEnd;
+        chunks[i].inventory = inventory;
+        p = chunkEnd;
+    }
+    
+    // Parse chunks in parallel, using this thread for the first chunk
+    for (int i = 1; i < threads; i++)
+        if (pthread_create(&workers[i], NULL, loader_parseChunk, 
+                &chunks[i]) != 0) {
+            fprintf(stderr, "Error: Unable to start thread in "
+                    "loader_readSalesParallel().\n");
+            exit(EXIT_FAILURE);
+        }
+    loader_parseChunk(&chunks[0]);
+    for (int i = 1; i < threads; i++)
+        pthread_join(workers[i], NULL);
+    double parsed = loader_now();
+    
+    // Apply sales in file order, growing sales list once for all records
+    int lineOffset = 0, total = 0;
+    for (int i = 0; i < threads; i++)
+        total += chunks[i].count;
+    sales_reserve(sales, total);
+    for (int i = 0; i < threads; i++) {
+        for (int r = 0; r < chunks[i].count; r++) {
+            LoaderRecord *record = &chunks[i].records[r];
+            
+            if (record->malformed)
+                fprintf(stderr, "Error: Malformed line %d in '%s' "
+                        "in loader_readSalesParallel().\n", 
+                        lineOffset + record->quantity, fileName);
+            else if (record->item)
+                sales_addItem(sales, record->item, record->date, 
+                        record->quantity);
+        }
+        lineOffset += chunks[i].lines;
+        free(chunks[i].records);
+    }
+    double applied = loader_now();
+    
+    free(chunks);
+    free(workers);
+    mappedFile_close(&file);
+    
+    // Report phase timings
+    if (timings) {
+        timings->map     = mapped - start;
+        timings->parse   = parsed - mapped;
+        timings->apply   = applied - parsed;
+        timings->total   = applied - start;
+        timings->threads = threads;
+    }
+}
+
+/**
+ * Method for the producer of a pipeline queue to push a item, waiting if
+ * the queue is full.
+ * 
+ * @param Pointer to queue.
+ * @param Pointer to item, or null to mark the end of the stream.
+ */
+static void loader_queuePush(LoaderQueue *queue, void *item) {
+    size_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    while (tail - atomic_load_explicit(&queue->head, memory_order_acquire) 
+            == LOADER_PIPELINE_QUEUE)
+        sched_yield();
+    
+    queue->slots[tail % LOADER_PIPELINE_QUEUE] = item;
+    atomic_store_explicit(&queue->tail, tail + 1, memory_order_release);
+}
+
+/**
+ * Method for the consumer of a pipeline queue to pop the next item, 
+ * waiting if the queue is empty. Counts each wait as a stall and adds the
+ * number of items waiting to the occupancy total.
+ * 
+ * @param  Pointer to queue.
+ * @param  Pointer to stall counter.
+ * @param  Pointer to occupancy total.
+ * @return Pointer to item, or null at the end of the stream.
+ */
+static void *loader_queuePop(LoaderQueue *queue, long *stalls, 
+        double *occupancy) {
+    size_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    size_t tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+    
+    if (tail == head) {
+        (*stalls)++;
+        while ((tail = atomic_load_explicit(&queue->tail, 
+                memory_order_acquire)) == head)
+            sched_yield();
+    }
+    *occupancy += tail - head;
+    
+    void *item = queue->slots[head % LOADER_PIPELINE_QUEUE];
+    atomic_store_explicit(&queue->head, head + 1, memory_order_release);
+    return item;
+}
+
+/**
+ * Method to grow a pipeline block to at least a given capacity. Or 
+ * generates error message if memory allocation fails and terminates 
+ * program.
+ * 
+ * @param Pointer to block.
+ * @param Capacity needed.
+ */
+static void loader_blockGrow(LoaderBlock *block, size_t capacity) {
+    size_t grown = block->capacity;
+    while (grown < capacity)
+        grown *= 2;
+    
+    char *data = (char*)realloc(block->data, grown);
+    // Null check memory allocation
+    if (!data) {
+        fprintf(stderr, "Error: Unable to allocate memory in "
+                "loader_blockGrow().\n");
+        exit(EXIT_FAILURE);
+    }
+    block->data     = data;
+    block->capacity = grown;
+}
+
+/**
+ * Thread method of the read stage of a pipelined load, filling free blocks
+ * from the file. Each block is cut after its last newline and the partial
+ * line carried over to the next, so no line is split. A block is grown if
+ * it can not hold a single line.
+ * 
+ * @param  Pointer to pipeline.
+ * @return Null.
+ */
+static void *loader_readBlocks(void *argument) {
+    LoaderPipeline *pipeline = (LoaderPipeline*)argument;
+    LoaderStageStats *stage = &pipeline->stats.read;
+    double unused = 0;
+    
+    LoaderBlock *block = (LoaderBlock*)loader_queuePop(
+            &pipeline->freeBlocks, &stage->outputStalls, &unused);
+    block->size = 0;
+    
+    for (;;) {
+        // Fill block until full or end of file
+        int finished = 0;
+        while (block->size < block->capacity) {
+            ssize_t count = read(pipeline->descriptor, 
+                    block->data + block->size, 
+                    block->capacity - block->size);
+            if ((count < 0) && (errno == EINTR))
+                continue;
+            if (count < 0) {
+                fprintf(stderr, "Error: Unable to read '%s' "
+                        "in loader_readBlocks().\n", pipeline->fileName);
+                exit(EXIT_FAILURE);
+            }
+            if (count == 0) {
+                finished = 1;
+                break;
+            }
+            block->size += count;
+        }
+        if (finished)
+            break;
+        
+        // Find last newline, growing block if it holds no whole line
+        const char *newline = block->data + block->size;
+        while ((newline > block->data) && (newline[-1] != '\n'))
+            newline--;
+        if (newline == block->data) {
+            loader_blockGrow(block, block->capacity * 2);
+            continue;
+        }
+        
+        // Carry partial last line over to next block
+        LoaderBlock *next = (LoaderBlock*)loader_queuePop(
+                &pipeline->freeBlocks, &stage->outputStalls, &unused);
+        size_t carried = block->data + block->size - newline;
+        if (next->capacity <= carried)
+            loader_blockGrow(next, carried + 1);
+        memcpy(next->data, newline, carried);
+        next->size = carried;
+        
+        block->size -= carried;
+        loader_queuePush(&pipeline->fullBlocks, block);
+        stage->items++;
+        block = next;
+    }
+    
+    if (block->size > 0) {
+        loader_queuePush(&pipeline->fullBlocks, block);
+        stage->items++;
+    }
+    loader_queuePush(&pipeline->fullBlocks, NULL);
+    
+    return NULL;
+}
+
+/**
+ * Thread method of the parse stage of a pipelined load, parsing lines of 
+ * full blocks into batches of records and resolving IDs against the 
+ * inventory, which is only read.
+ * 
+ * @param  Pointer to pipeline.
+ * @return Null.
+ */
+static void *loader_parseBlocks(void *argument) {
+    LoaderPipeline *pipeline = (LoaderPipeline*)argument;
+    LoaderStageStats *stage = &pipeline->stats.parse;
+    double unused = 0;
+    long popped = 1;
+    int lineNumber = 0;
+    
+    LoaderBatch *batch = (LoaderBatch*)loader_queuePop(
+            &pipeline->freeBatches, &stage->outputStalls, &unused);
+    batch->count = 0;
+    
+    LoaderBlock *block;
+    while ((block = (LoaderBlock*)loader_queuePop(&pipeline->fullBlocks, 
+            &stage->inputStalls, &stage->occupancy))) {
+        const char *p = block->data, *end = block->data + block->size, *next;
+        popped++;
+        
+        for (; p < end; p = next) {
+            const char *lineEnd = loader_lineEnd(p, end, &next);
+            lineNumber++;
+            
+            // Skip blank lines
+            p = loader_skipSpaces(p, lineEnd);
+            if (p == lineEnd)
+                continue;
+            
+            // Hand on full batch
+            if (batch->count == LOADER_PIPELINE_RECORDS) {
+                loader_queuePush(&pipeline->fullBatches, batch);
+                batch = (LoaderBatch*)loader_queuePop(&pipeline->freeBatches,
+                        &stage->outputStalls, &unused);
+                batch->count = 0;
+            }
+            loader_parseRecord(p, lineEnd, pipeline->inventory, lineNumber, 
+                    &batch->records[batch->count++]);
+        }
+        
+        loader_queuePush(&pipeline->freeBlocks, block);
+    }
+    
+    if (batch->count > 0)
+        loader_queuePush(&pipeline->fullBatches, batch);
+    loader_queuePush(&pipeline->fullBatches, NULL);
+    
+    stage->items      = lineNumber;
+    stage->occupancy /= popped;
+    return NULL;
+}
+
+/**
+ * Method to read sales from a file through a pipeline of three stages: a
+ * read thread filling large blocks from the file, a parse thread turning 
+ * blocks into batches of records, and this thread applying them to the 
+ * inventory in file order. Stages are joined by bounded queues of a fixed
+ * number of recycled blocks and batches, so reading, parsing and applying
+ * overlap and no memory is allocated per block. Rejected sales are 
+ * exactly those rejected by loader_readSales(). Or generates error 
+ * message if file can not be read or a thread can not be started and 
+ * terminates program.
+ * 
+ * @param Pointer to sales list where all sales will be added to.
+ * @param Pointer to inventory containing stock items sold.
+ * @param File name of file to be read. 
+ * @param Pointer to where stage statistics will be stored, or null.
+ */
+void loader_readSalesPipelined(Sales* sales, Inventory* inventory, 
+        const char *fileName, LoaderPipelineStats *stats) {
+    double start = loader_now();
+    LoaderPipeline *pipeline = (LoaderPipeline*)aligned_alloc(
+            _Alignof(LoaderPipeline), sizeof(LoaderPipeline));
+    LoaderBatch *batches = (LoaderBatch*)malloc(sizeof(LoaderBatch) 
+            * LOADER_PIPELINE_BATCHES);
+    // Null check memory allocation
+    if (!pipeline || !batches) {
+        fprintf(stderr, "Error: Unable to allocate memory in "
+                "loader_readSalesPipelined().\n");
+        exit(EXIT_FAILURE);
+    }
+    memset(pipeline, 0, sizeof(LoaderPipeline));
+    
+    // Check file has correctly opened
+    pipeline->descriptor = open(fileName, O_RDONLY);
+    if (pipeline->descriptor < 0) {
+        fprintf(stderr, "Error: Unable to open '%s' for reading "
+                "in loader_readSalesPipelined().\n", fileName);
+        exit(EXIT_FAILURE);
+    }
+    // File is read once from start to end
+    posix_fadvise(pipeline->descriptor, 0, 0, POSIX_FADV_SEQUENTIAL);
+    pipeline->fileName  = fileName;
+    pipeline->inventory = inventory;
+    
+    // Fill free queues with every block and batch
+    for (int i = 0; i < LOADER_PIPELINE_BLOCKS; i++) {
+        LoaderBlock *block = &pipeline->blocks[i];
+        block->data     = (char*)malloc(LOADER_PIPELINE_BLOCK);
+        block->capacity = LOADER_PIPELINE_BLOCK;
+        // Null check memory allocation
+        if (!block->data) {
+            fprintf(stderr, "Error: Unable to allocate memory in "
+                    "loader_readSalesPipelined().\n");
+            exit(EXIT_FAILURE);
+        }
+        loader_queuePush(&pipeline->freeBlocks, block);
+    }
+    for (int i = 0; i < LOADER_PIPELINE_BATCHES; i++)
+        loader_queuePush(&pipeline->freeBatches, &batches[i]);
+    
+    // Start read and parse stages
+    pthread_t reader, parser;
+    if ((pthread_create(&reader, NULL, loader_readBlocks, pipeline) != 0)
+            || (pthread_create(&parser, NULL, loader_parseBlocks, 
+                pipeline) != 0)) {
+        fprintf(stderr, "Error: Unable to start thread in "
+                "loader_readSalesPipelined().\n");
+        exit(EXIT_FAILURE);
+    }
+    
+    // Apply batches in file order
+    LoaderStageStats *stage = &pipeline->stats.apply;
+    long popped = 1;
+    LoaderBatch *batch;
+    while ((batch = (LoaderBatch*)loader_queuePop(&pipeline->fullBatches, 
+            &stage->inputStalls, &stage->occupancy))) {
+        popped++;
+        
+        for (int r = 0; r < batch->count; r++) {
+            LoaderRecord *record = &batch->records[r];
+            
+            if (record->malformed)
+                fprintf(stderr, "Error: Malformed line %d in '%s' "
+                        "in loader_readSalesPipelined().\n", 
+                        record->quantity, fileName);
+            else if (record->item)
+                sales_addItem(sales, record->item, record->date, 
+                        record->quantity);
+        }
+        stage->items += batch->count;
+        
+        loader_queuePush(&pipeline->freeBatches, batch);
+    }
+    stage->occupancy /= popped;
+    
+    pthread_join(reader, NULL);
+    pthread_join(parser, NULL);
+    close(pipeline->descriptor);
+    pipeline->stats.total = loader_now() - start;
+    
+    // Report stage statistics
+    if (stats)
+        *stats = pipeline->stats;
+    
+    for (int i = 0; i < LOADER_PIPELINE_BLOCKS; i++)
+        free(pipeline->blocks[i].data);
+    free(batches);
+    free(pipeline);
+}
@@ -0,0 +1,156 @@
+/* 
+ * File:   Loader.h
+ * Author: Paulo Jorge
+ */
+
+#ifndef LOADER_H
+#define LOADER_H
+
+#include <stddef.h>
+
+#include "Inventory.h"
+#include "Sales.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Structure defining a read only memory mapping of a whole file.
+ */
+typedef struct MappedFileStruct {
+    const char *data;
+    size_t size;
+}
+MappedFile;
+
+/**
+ * Structure holding the time taken by each phase of a parallel load, in 
+ * seconds.
+ */
+typedef struct LoaderTimingsStruct {
+    double map, parse, apply, total;
+    int threads;
+}
+LoaderTimings;
+
+/**
+ * Structure holding statistics of one stage of a pipelined load: items 
+ * handled, times it waited for input and for a free buffer to output to,
+ * and mean number of items waiting in its input queue when it took one. A
+ * stage whose input queue is usually full is the bottleneck, one whose 
+ * input often runs dry is starved by the stage before it.
+ */
+typedef struct LoaderStageStatsStruct {
+    long items, inputStalls, outputStalls;
+    double occupancy;
+}
+LoaderStageStats;
+
+/**
+ * Structure holding statistics of each stage of a pipelined load, counting
+ * blocks read, lines parsed and records applied, and its total time in 
+ * seconds.
+ */
+typedef struct LoaderPipelineStatsStruct {
+    LoaderStageStats read, parse, apply;
+    double total;
+}
+LoaderPipelineStats;
+
+/**
+ * Method to map a whole file into memory for reading. Or generates error 
+ * message if file can not be opened or mapped and terminates program.
+ * 
+ * @param  Pointer to mapping to be filled in.
+ * @param  File name of file to be mapped.
+ */
+void mappedFile_open(MappedFile *file, const char *fileName);
+
+/**
+ * Method to map a whole file into memory for reading, if it can be.
+ * 
+ * @param  Pointer to mapping to be filled in, left empty on failure.
+ * @param  File name of file to be mapped.
+ * @return 1 if file was mapped or 0 if it could not be opened or mapped.
+ */
+int mappedFile_tryOpen(MappedFile *file, const char *fileName);
+
+/**
+ * Method to unmap a file mapped by mappedFile_open().
+ * 
+ * @param Pointer to mapping to be closed.
+ */
+void mappedFile_close(MappedFile *file);
+
+/**
+ * Method to read stock items from a file and add each one into a 
+ * existing inventory. The file is memory mapped and scanned in place, each
+ * stock item and its ID and description taken from the inventory's arena 
+ * in one piece, so they are freed with the inventory. Or generates error
+ * message if file can not be read or contains a duplicate ID and 
+ * terminates program.
+ * 
+ * @param Pointer to inventory where all stock items will be added to.
+ * @param File name of file to be read. 
+ */
+void loader_readInventory(Inventory* inventory, const char *fileName);
+
+/**
+ * Method to read sales from a file and add each one into a existing sales
+ * list. The file is memory mapped and scanned in place, dates and 
+ * quantities are parsed directly and IDs are looked up as slices of the 
+ * mapping, so no field is copied. Malformed lines are reported and 
+ * skipped. Or generates error message if file can not be read and 
+ * terminates program.
+ * 
+ * @param Pointer to sales list where all sales will be added to.
+ * @param Pointer to inventory containing stock items sold.
+ * @param File name of file to be read. 
+ */
+void loader_readSales(Sales* sales, Inventory* inventory, 
+        const char *fileName);
+
+/**
+ * Method to read sales from a file using several threads. The mapped file
+ * is split into chunks at line boundaries which are parsed in parallel, 
+ * resolving IDs to stock items, then the sales are applied to the 
+ * inventory in original file order so sales rejected for insufficient 
+ * stock are exactly those rejected by loader_readSales(). Or generates 
+ * error message if file can not be read or a thread can not be started
+ * and terminates program.
+ * 
+ * @param Pointer to sales list where all sales will be added to.
+ * @param Pointer to inventory containing stock items sold.
+ * @param File name of file to be read. 
+ * @param Integer number of parse threads, or 0 for one per processor.
+ * @param Pointer to where phase timings will be stored, or null.
+ */
+void loader_readSalesParallel(Sales* sales, Inventory* inventory, 
+        const char *fileName, int threads, LoaderTimings *timings);
+
+/**
+ * Method to read sales from a file through a pipeline of three stages: a
+ * read thread filling large blocks from the file, a parse thread turning 
+ * blocks into batches of records, and this thread applying them to the 
+ * inventory in file order. Stages are joined by bounded queues of a fixed
+ * number of recycled blocks and batches, so reading, parsing and applying
+ * overlap and no memory is allocated per block. Rejected sales are 
+ * exactly those rejected by loader_readSales(). Or generates error 
+ * message if file can not be read or a thread can not be started and 
+ * terminates program.
+ * 
+ * @param Pointer to sales list where all sales will be added to.
+ * @param Pointer to inventory containing stock items sold.
+ * @param File name of file to be read. 
+ * @param Pointer to where stage statistics will be stored, or null.
+ */
+void loader_readSalesPipelined(Sales* sales, Inventory* inventory, 
+        const char *fileName, LoaderPipelineStats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LOADER_H */
+
@@ -0,0 +1,27 @@
+/* 
+ * File:   Money.c
+ * Author: Paulo Jorge
+ */
+
+#include <stdio.h>
+
+#include "Money.h"
+
+/**
+ * Method to format a amount of money in pounds with two decimal places, 
+ * such as "12.05", into a buffer.
+ * 
+ * @param  Amount of money.
+ * @param  Buffer of at least MONEY_BUFFER chars to write amount to.
+ * @return Buffer containing formatted amount.
+ */
+char *money_format(Money amount, char *buffer) {
+    // Format magnitude, negating as unsigned so the lowest amount works
+    unsigned long long pennies = (amount < 0) 
+            ? 0ULL - (unsigned long long)amount : (unsigned long long)amount;
+    
+    snprintf(buffer, MONEY_BUFFER, "%s%llu.%02llu", (amount < 0) ? "-" : "", 
+            pennies / 100, pennies % 100);
+    
+    return buffer;
+}
@@ -0,0 +1,65 @@
+/* 
+ * File:   Money.h
+ * Author: Paulo Jorge
+ */
+
+#ifndef MONEY_H
+#define MONEY_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Buffer size for a formatted amount of money, enough for any amount 
+ * including sign, decimal point and null terminator.
+ */
+#define MONEY_BUFFER 24
+
+/**
+ * Amount of money as a whole number of pennies. Prices, costs and totals 
+ * are kept in pennies so they add up exactly and are only converted to 
+ * pounds when printed.
+ */
+typedef int64_t Money;
+
+/**
+ * Method to get the total cost of a number of items at a price.
+ * 
+ * @param  Price of one item.
+ * @param  Integer number of items.
+ * @return Total cost.
+ */
+static inline Money money_multiply(Money price, long long quantity) {
+    return price * quantity;
+}
+
+/**
+ * Method to convert a amount of money to pounds, for code still using 
+ * float prices. Amounts above 2^24 pennies lose pennies when converted.
+ * 
+ * @param  Amount of money.
+ * @return Float amount in pounds.
+ */
+static inline float money_toPounds(Money amount) {
+    return (float)(amount / 100) + (float)(amount % 100) / 100;
+}
+
+/**
+ * Method to format a amount of money in pounds with two decimal places, 
+ * such as "12.05", into a buffer.
+ * 
+ * @param  Amount of money.
+ * @param  Buffer of at least MONEY_BUFFER chars to write amount to.
+ * @return Buffer containing formatted amount.
+ */
+char *money_format(Money amount, char *buffer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MONEY_H */
+
@@ -0,0 +1,125 @@
+/* 
+ * File:   Pool.c
+ * Author: Paulo Jorge
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "Pool.h"
+
+/**
+ * Method to initialise a empty pool of objects of a given size, which is
+ * rounded up to a power of two up to a cache line, or to whole cache 
+ * lines above it.
+ * 
+ * @param Pointer to pool.
+ * @param Size of each object in bytes.
+ */
+void pool_init(Pool *pool, size_t objectSize) {
+    // Objects must hold a free list link
+    size_t size = sizeof(void*);
+    if (objectSize > POOL_LINE_SIZE)
+        size = (objectSize + POOL_LINE_SIZE - 1) / POOL_LINE_SIZE 
+                * POOL_LINE_SIZE;
+    else
+        while (size < objectSize)
+            size *= 2;
+    
+    // Objects start after the header's cache line
+    pool->slabs      = NULL;
+    pool->freeList   = NULL;
+    pool->objectSize = size;
+    pool->perSlab    = (int)((POOL_SLAB_SIZE - POOL_LINE_SIZE) / size);
+    if (pool->perSlab < 1)
+        pool->perSlab = 1;
+    pool->slabCount  = 0;
+    pool->live       = 0;
+    pool->peak       = 0;
+}
+
+/**
+ * Method to take a object from a pool, reusing a released object if there
+ * is one. Or generates error message if memory allocation fails and 
+ * terminates program.
+ * 
+ * @param  Pointer to pool.
+ * @return Pointer to object.
+ */
+void *pool_alloc(Pool *pool) {
+    // Allocate a new slab and put all its objects on the free list, in 
+    // order so they are handed out from the start of the slab
+    if (!pool->freeList) {
+        size_t size = POOL_LINE_SIZE + pool->objectSize * pool->perSlab;
+        size = (size + POOL_LINE_SIZE - 1) / POOL_LINE_SIZE * POOL_LINE_SIZE;
+        PoolSlab *slab = (PoolSlab*)aligned_alloc(POOL_LINE_SIZE, size);
+        // Null check memory allocation
+        if (!slab) {
+            fprintf(stderr, "Error: Unable to allocate memory in "
+                    "pool_alloc().\n");
+            exit(EXIT_FAILURE);
+        }
+        slab->next  = pool->slabs;
+        pool->slabs = slab;
+        pool->slabCount++;
+        
+        char *objects = (char*)slab + POOL_LINE_SIZE;
+        for (int i = pool->perSlab - 1; i >= 0; i--) {
+            void **object = (void**)(objects + pool->objectSize * i);
+            *object = pool->freeList;
+            pool->freeList = object;
+        }
+    }
+    
+    void **object = (void**)pool->freeList;
+    pool->freeList = *object;
+    if (++pool->live > pool->peak)
+        pool->peak = pool->live;
+    
+    return object;
+}
+
+/**
+ * Method to release a object back to the pool it was taken from, to be 
+ * reused by a later pool_alloc().
+ * 
+ * @param Pointer to pool.
+ * @param Pointer to object.
+ */
+void pool_release(Pool *pool, void *object) {
+    *(void**)object = pool->freeList;
+    pool->freeList = object;
+    pool->live--;
+}
+
+/**
+ * Method to get the occupancy of a pool's slabs.
+ * 
+ * @param Pointer to pool.
+ * @param Pointer to where statistics will be stored.
+ */
+void pool_getStats(const Pool *pool, PoolStats *stats) {
+    stats->slabs     = pool->slabCount;
+    stats->capacity  = (long)pool->slabCount * pool->perSlab;
+    stats->live      = pool->live;
+    stats->peak      = pool->peak;
+    stats->occupancy = stats->capacity 
+            ? (double)stats->live / stats->capacity : 0;
+}
+
+/**
+ * Method to free every slab of a pool, leaving it empty. Objects taken 
+ * from it must no longer be used.
+ * 
+ * @param Pointer to pool.
+ */
+void pool_free(Pool *pool) {
+    PoolSlab *slab = pool->slabs;
+    while (slab) {
+        PoolSlab *next = slab->next;
+        free(slab);
+        slab = next;
+    }
+    
+    pool_init(pool, pool->objectSize);
+}
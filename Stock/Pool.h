@@ -0,0 +1,111 @@
+/* 
+ * File:   Pool.h
+ * Author: Paulo Jorge
+ */
+
+#ifndef POOL_H
+#define POOL_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Size of each slab of a pool in bytes, a multiple of the cache line size.
+ */
+#define POOL_SLAB_SIZE 4096
+
+/**
+ * Cache line size slabs are aligned to.
+ */
+#define POOL_LINE_SIZE 64
+
+/**
+ * Slab of a pool, holding objects after its header. Slabs are aligned to
+ * a cache line and objects are sized so none straddles two lines.
+ */
+typedef struct PoolSlabStruct {
+    struct PoolSlabStruct *next;
+}
+PoolSlab;
+
+/**
+ * Pool of objects of a single size, taken from slabs and kept on a free
+ * list when released so they are reused before any new slab is 
+ * allocated. Slabs are only freed with the pool.
+ */
+typedef struct PoolStruct {
+    PoolSlab *slabs;
+    // Released objects, linked through their first bytes
+    void *freeList;
+    // Size of each object rounded up, and number of objects per slab
+    size_t objectSize;
+    int perSlab, slabCount;
+    // Objects in use and most ever in use at once
+    long live, peak;
+}
+Pool;
+
+/**
+ * Structure holding the occupancy of a pool's slabs.
+ */
+typedef struct PoolStatsStruct {
+    int slabs;
+    long capacity, live, peak;
+    // Fraction of slab objects in use
+    double occupancy;
+}
+PoolStats;
+
+/**
+ * Method to initialise a empty pool of objects of a given size, which is
+ * rounded up to a power of two up to a cache line, or to whole cache 
+ * lines above it.
+ * 
+ * @param Pointer to pool.
+ * @param Size of each object in bytes.
+ */
+void pool_init(Pool *pool, size_t objectSize);
+
+/**
+ * Method to take a object from a pool, reusing a released object if there
+ * is one. Or generates error message if memory allocation fails and 
+ * terminates program.
+ * 
+ * @param  Pointer to pool.
+ * @return Pointer to object.
+ */
+void *pool_alloc(Pool *pool);
+
+/**
+ * Method to release a object back to the pool it was taken from, to be 
+ * reused by a later pool_alloc().
+ * 
+ * @param Pointer to pool.
+ * @param Pointer to object.
+ */
+void pool_release(Pool *pool, void *object);
+
+/**
+ * Method to get the occupancy of a pool's slabs.
+ * 
+ * @param Pointer to pool.
+ * @param Pointer to where statistics will be stored.
+ */
+void pool_getStats(const Pool *pool, PoolStats *stats);
+
+/**
+ * Method to free every slab of a pool, leaving it empty. Objects taken 
+ * from it must no longer be used.
+ * 
+ * @param Pointer to pool.
+ */
+void pool_free(Pool *pool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* POOL_H */
@@ -0,0 +1,121 @@
+/* 
+ * File:   Ranking.c
+ * Author: Paulo Jorge
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "Ranking.h"
+
+/**
+ * Method to check if one entry ranks above another, ranking entries with
+ * equal totals in index order.
+ * 
+ * @param  Pointer to first entry.
+ * @param  Pointer to second entry.
+ * @return 1 if first entry ranks above second or 0 if not.
+ */
+static inline int ranking_ranksAbove(const RankingEntry *entry1,
+        const RankingEntry *entry2) {
+    return (entry1->value > entry2->value)
+            || ((entry1->value == entry2->value)
+                && (entry1->index < entry2->index));
+}
+
+/**
+ * Method to move a entry down a heap kept with its lowest ranked entry at
+ * the root.
+ * 
+ * @param Array of entries forming heap.
+ * @param Integer number of entries in heap.
+ * @param Integer position of entry to be moved down.
+ */
+static void ranking_siftDown(RankingEntry *heap, int count, int position) {
+    RankingEntry entry = heap[position];
+
+    for (;;) {
+        int child = position * 2 + 1;
+        if (child >= count)
+            break;
+        // Pick lower ranked child
+        if ((child + 1 < count)
+                && ranking_ranksAbove(&heap[child], &heap[child + 1]))
+            child++;
+        if (!ranking_ranksAbove(&entry, &heap[child]))
+            break;
+        heap[position] = heap[child];
+        position = child;
+    }
+    heap[position] = entry;
+}
+
+/**
+ * Method to offer a entry to a heap keeping the best entries seen so far,
+ * with the lowest ranked of them at the root, so each entry once the heap
+ * is full is compared against the root only.
+ * 
+ * @param  Array of at least count entries forming heap.
+ * @param  Integer number of entries in heap.
+ * @param  Integer maximum number of entries to keep.
+ * @param  Total of entry.
+ * @param  Integer index of entry.
+ * @return Integer number of entries in heap after offer.
+ */
+int ranking_offer(RankingEntry *heap, int found, int count, long long value,
+        int index) {
+    RankingEntry entry = { value, index };
+
+    if (found < count) {
+        // Heap not yet full, add entry and restore heap from bottom up
+        int position = found++;
+        while (position > 0) {
+            int parent = (position - 1) / 2;
+            if (!ranking_ranksAbove(&heap[parent], &entry))
+                break;
+            heap[position] = heap[parent];
+            position = parent;
+        }
+        heap[position] = entry;
+    } else if (ranking_ranksAbove(&entry, &heap[0])) {
+        heap[0] = entry;
+        ranking_siftDown(heap, found, 0);
+    }
+
+    return found;
+}
+
+/**
+ * Method to sort a heap built by ranking_offer() highest ranked first.
+ * 
+ * @param Array of entries forming heap.
+ * @param Integer number of entries in heap.
+ */
+void ranking_sort(RankingEntry *heap, int found) {
+    // Move each lowest entry to the end
+    for (int end = found - 1; end > 0; end--) {
+        RankingEntry lowest = heap[0];
+        heap[0] = heap[end];
+        heap[end] = lowest;
+        ranking_siftDown(heap, end, 0);
+    }
+}
+
+/**
+ * Method to allocate a array of entries for a heap of at most a number of
+ * entries. Or generates error message if memory allocation fails and
+ * terminates program.
+ * 
+ * @param  Integer maximum number of entries, at least 1.
+ * @return Pointer to newly allocated entries.
+ */
+RankingEntry *ranking_new(int count) {
+    RankingEntry *heap = (RankingEntry*)malloc(sizeof(RankingEntry) * count);
+    // Null check memory allocation
+    if (!heap) {
+        fprintf(stderr, "Error: Unable to allocate memory in "
+                "ranking_new().\n");
+        exit(EXIT_FAILURE);
+    }
+    return heap;
+}
@@ -0,0 +1,62 @@
+/* 
+ * File:   Ranking.h
+ * Author: Paulo Jorge
+ */
+
+#ifndef RANKING_H
+#define RANKING_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Structure defining a entry being ranked, by its total and its index in
+ * the dense totals it was taken from. Entries with greater totals rank
+ * higher and entries with equal totals rank in index order, so indices
+ * should follow the order ties are to be broken in.
+ */
+typedef struct RankingEntryStruct {
+    long long value;
+    int index;
+}
+RankingEntry;
+
+/**
+ * Method to offer a entry to a heap keeping the best entries seen so far,
+ * with the lowest ranked of them at the root, so each entry once the heap
+ * is full is compared against the root only.
+ * 
+ * @param  Array of at least count entries forming heap.
+ * @param  Integer number of entries in heap.
+ * @param  Integer maximum number of entries to keep.
+ * @param  Total of entry.
+ * @param  Integer index of entry.
+ * @return Integer number of entries in heap after offer.
+ */
+int ranking_offer(RankingEntry *heap, int found, int count, long long value,
+        int index);
+
+/**
+ * Method to sort a heap built by ranking_offer() highest ranked first.
+ * 
+ * @param Array of entries forming heap.
+ * @param Integer number of entries in heap.
+ */
+void ranking_sort(RankingEntry *heap, int found);
+
+/**
+ * Method to allocate a array of entries for a heap of at most a number of
+ * entries. Or generates error message if memory allocation fails and
+ * terminates program.
+ * 
+ * @param  Integer maximum number of entries, at least 1.
+ * @return Pointer to newly allocated entries.
+ */
+RankingEntry *ranking_new(int count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RANKING_H */
@@ -0,0 +1,166 @@
+/* 
+ * File:   Report.c
+ * Author: Paulo Jorge
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include "Report.h"
+
+// Most chars written for a integer, including sign
+#define REPORT_INT_BUFFER 20
+
+/**
+ * Method to initialise a empty report writer.
+ * 
+ * @param Pointer to report writer.
+ * @param File descriptor output is written to.
+ */
+void report_init(Report *report, int descriptor) {
+    report->descriptor = descriptor;
+    report->used       = 0;
+}
+
+/**
+ * Method to write chars straight to a file descriptor, retrying partial
+ * writes. Or generates error message if output can not be written and 
+ * terminates program.
+ * 
+ * @param File descriptor.
+ * @param Chars to be written.
+ * @param Number of chars.
+ */
+static void report_writeAll(int descriptor, const char *text, 
+        size_t length) {
+    while (length > 0) {
+        ssize_t written = write(descriptor, text, length);
+        if ((written < 0) && (errno == EINTR))
+            continue;
+        if (written <= 0) {
+            fprintf(stderr, "Error: Unable to write report "
+                    "in report_writeAll().\n");
+            exit(EXIT_FAILURE);
+        }
+        text   += written;
+        length -= written;
+    }
+}
+
+/**
+ * Method to write all buffered output to the report's file descriptor. 
+ * Output buffered by stdio for the same descriptor is written first, so 
+ * both stay in order. Or generates error message if output can not be 
+ * written and terminates program.
+ * 
+ * @param Pointer to report writer.
+ */
+void report_flush(Report *report) {
+    if (report->descriptor == fileno(stdout))
+        fflush(stdout);
+    
+    report_writeAll(report->descriptor, report->buffer, report->used);
+    report->used = 0;
+}
+
+/**
+ * Method to write a number of chars to a report, flushing as needed.
+ * 
+ * @param Pointer to report writer.
+ * @param Chars to be written.
+ * @param Number of chars.
+ */
+void report_write(Report *report, const char *text, size_t length) {
+    if (REPORT_BUFFER - report->used < length) {
+        report_flush(report);
+        
+        // Write text too large to buffer straight out
+        if (length > REPORT_BUFFER) {
+            report_writeAll(report->descriptor, text, length);
+            return;
+        }
+    }
+    
+    memcpy(report->buffer + report->used, text, length);
+    report->used += length;
+}
+
+/**
+ * Method to get room for a number of chars at the end of a report's 
+ * buffer, flushing it if needed. The chars must be no more than 
+ * REPORT_BUFFER.
+ * 
+ * @param  Pointer to report writer.
+ * @param  Number of chars needed.
+ * @return Pointer to where chars can be written.
+ */
+static inline char *report_reserve(Report *report, size_t length) {
+    if (REPORT_BUFFER - report->used < length)
+        report_flush(report);
+    
+    return report->buffer + report->used;
+}
+
+/**
+ * Method to write a integer to a report.
+ * 
+ * @param Pointer to report writer.
+ * @param Integer to be written.
+ */
+void report_int(Report *report, long long value) {
+    char digits[REPORT_INT_BUFFER];
+    int count = 0;
+    
+    // Write digits backwards, negating as unsigned so the lowest value works
+    unsigned long long magnitude = (value < 0) 
+            ? 0ULL - (unsigned long long)value : (unsigned long long)value;
+    do {
+        digits[count++] = '0' + magnitude % 10;
+        magnitude /= 10;
+    } while (magnitude > 0);
+    
+    char *p = report_reserve(report, count + 1);
+    if (value < 0)
+        *p++ = '-';
+    while (count > 0)
+        *p++ = digits[--count];
+    report->used = p - report->buffer;
+}
+
+/**
+ * Method to write a amount of money in pounds with two decimal places, 
+ * such as "12.05", to a report.
+ * 
+ * @param Pointer to report writer.
+ * @param Amount of money.
+ */
+void report_money(Report *report, Money amount) {
+    unsigned long long pennies = (amount < 0) 
+            ? 0ULL - (unsigned long long)amount : (unsigned long long)amount;
+    
+    if (amount < 0)
+        report_write(report, "-", 1);
+    report_int(report, (long long)(pennies / 100));
+    
+    char *p = report_reserve(report, 3);
+    p[0] = '.';
+    p[1] = '0' + (pennies % 100) / 10;
+    p[2] = '0' + pennies % 10;
+    report->used += 3;
+}
+
+/**
+ * Method to write a date in the form "DD/MM/YYYY" to a report.
+ * 
+ * @param Pointer to report writer.
+ * @param Date to be written.
+ */
+void report_date(Report *report, Date date) {
+    // Format in place, the null terminator is overwritten by what follows
+    date_format(date, report_reserve(report, DATE_BUFFER));
+    report->used += DATE_BUFFER - 1;
+}
@@ -0,0 +1,104 @@
+/* 
+ * File:   Report.h
+ * Author: Paulo Jorge
+ */
+
+#ifndef REPORT_H
+#define REPORT_H
+
+#include <stddef.h>
+#include <string.h>
+
+#include "Money.h"
+#include "Date.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Size of the output buffer of a report writer.
+ */
+#define REPORT_BUFFER 65536
+
+/**
+ * Report writer formatting text into a large buffer, flushed to a file 
+ * descriptor with a single write() whenever it fills. Numbers, money and
+ * dates are formatted by hand, so writing a report allocates nothing and
+ * makes no call per field. Output must be flushed with report_flush() 
+ * once written.
+ */
+typedef struct ReportStruct {
+    int descriptor;
+    size_t used;
+    char buffer[REPORT_BUFFER];
+}
+Report;
+
+/**
+ * Method to initialise a empty report writer.
+ * 
+ * @param Pointer to report writer.
+ * @param File descriptor output is written to.
+ */
+void report_init(Report *report, int descriptor);
+
+/**
+ * Method to write all buffered output to the report's file descriptor. 
+ * Output buffered by stdio for the same descriptor is written first, so 
+ * both stay in order. Or generates error message if output can not be 
+ * written and terminates program.
+ * 
+ * @param Pointer to report writer.
+ */
+void report_flush(Report *report);
+
+/**
+ * Method to write a number of chars to a report, flushing as needed.
+ * 
+ * @param Pointer to report writer.
+ * @param Chars to be written.
+ * @param Number of chars.
+ */
+void report_write(Report *report, const char *text, size_t length);
+
+/**
+ * Method to write a integer to a report.
+ * 
+ * @param Pointer to report writer.
+ * @param Integer to be written.
+ */
+void report_int(Report *report, long long value);
+
+/**
+ * Method to write a amount of money in pounds with two decimal places, 
+ * such as "12.05", to a report.
+ * 
+ * @param Pointer to report writer.
+ * @param Amount of money.
+ */
+void report_money(Report *report, Money amount);
+
+/**
+ * Method to write a date in the form "DD/MM/YYYY" to a report.
+ * 
+ * @param Pointer to report writer.
+ * @param Date to be written.
+ */
+void report_date(Report *report, Date date);
+
+/**
+ * Method to write a null terminated string to a report.
+ * 
+ * @param Pointer to report writer.
+ * @param String to be written.
+ */
+static inline void report_string(Report *report, const char *text) {
+    report_write(report, text, strlen(text));
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* REPORT_H */
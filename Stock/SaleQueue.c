@@ -0,0 +1,289 @@
+/* 
+ * File:   SaleQueue.c
+ * Author: Paulo Jorge
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+
+#include "SaleQueue.h"
+
+/**
+ * Method for the applier to sleep until a producer fills the head slot or
+ * stopping begins. Sleeping is set before the head slot and stop are
+ * checked again, and producers check it after filling a slot, so either
+ * the applier sees the sale or the producer sees it sleeping.
+ * 
+ * @param Pointer to queue.
+ */
+static void saleQueue_sleep(SaleQueue *queue) {
+    SaleQueueSlot *slot = &queue->slots[queue->head & queue->mask];
+
+    pthread_mutex_lock(&queue->lock);
+    atomic_store(&queue->sleeping, 1);
+    if ((atomic_load(&slot->sequence) == queue->head + 1)
+            || atomic_load(&queue->stop))
+        atomic_store(&queue->sleeping, 0);
+    while (atomic_load(&queue->sleeping))
+        pthread_cond_wait(&queue->wake, &queue->lock);
+    pthread_mutex_unlock(&queue->lock);
+}
+
+/**
+ * Method to wake the applier if it is sleeping.
+ * 
+ * @param Pointer to queue.
+ */
+static void saleQueue_wake(SaleQueue *queue) {
+    pthread_mutex_lock(&queue->lock);
+    if (atomic_load(&queue->sleeping)) {
+        atomic_store(&queue->sleeping, 0);
+        pthread_cond_signal(&queue->wake);
+    }
+    pthread_mutex_unlock(&queue->lock);
+}
+
+/**
+ * Applier thread method, taking every run of ready sales from the head of
+ * the queue up to SALE_QUEUE_BATCH at a time, applying them with
+ * sales_addBatch() and setting their completion slots. Slots are only
+ * freed for producers once their sales have been applied, so their IDs
+ * are used in place.
+ * 
+ * @param  Pointer to queue.
+ * @return Null.
+ */
+static void *saleQueue_apply(void *argument) {
+    SaleQueue *queue = (SaleQueue*)argument;
+    SaleRequest *requests = (SaleRequest*)malloc(sizeof(SaleRequest)
+            * SALE_QUEUE_BATCH);
+    unsigned char *accepted = (unsigned char*)malloc(SALE_QUEUE_BATCH);
+    // Null check memory allocation
+    if (!requests || !accepted) {
+        fprintf(stderr, "Error: Unable to allocate memory in "
+                "saleQueue_apply().\n");
+        exit(EXIT_FAILURE);
+    }
+
+    int idle = 0;
+    for (;;) {
+        // Read stop before checking for sales, so none pushed before it
+        // was set are missed
+        int stopping = atomic_load(&queue->stop);
+
+        // Take run of ready sales from head
+        int count = 0;
+        while (count < SALE_QUEUE_BATCH) {
+            SaleQueueSlot *slot =
+                    &queue->slots[(queue->head + count) & queue->mask];
+            if (atomic_load_explicit(&slot->sequence, memory_order_acquire)
+                    != queue->head + count + 1)
+                break;
+
+            requests[count] = (SaleRequest){ slot->date, slot->ID,
+                    slot->quantity };
+            count++;
+        }
+
+        if (count == 0) {
+            if (stopping)
+                break;
+            if (++idle < SALE_QUEUE_SPINS) {
+                sched_yield();
+                continue;
+            }
+            saleQueue_sleep(queue);
+            idle = 0;
+            continue;
+        }
+        idle = 0;
+
+        int made = sales_addBatch(queue->sales, queue->inventory, requests,
+                count, accepted);
+
+        // Report results and free slots for producers a lap later
+        for (int i = 0; i < count; i++) {
+            SaleQueueSlot *slot = &queue->slots[queue->head & queue->mask];
+            if (slot->completion)
+                atomic_store_explicit(&slot->completion->status,
+                        accepted[i] ? SALE_ACCEPTED : SALE_REJECTED,
+                        memory_order_release);
+            atomic_store_explicit(&slot->sequence,
+                    queue->head + queue->capacity, memory_order_release);
+            queue->head++;
+        }
+        atomic_fetch_add_explicit(&queue->applied, count,
+                memory_order_relaxed);
+        atomic_fetch_add_explicit(&queue->made, made, memory_order_relaxed);
+    }
+
+    free(requests);
+    free(accepted);
+    return NULL;
+}
+
+/**
+ * Method to allocate memory for a new queue and start its applier
+ * thread. Or generates error message if memory allocation fails or the
+ * thread can not be started and terminates program.
+ * 
+ * @param  Integer capacity, rounded up to a power of two.
+ * @param  Pointer to inventory containing stock items sold.
+ * @param  Pointer to sales list sales are appended to.
+ * @return Pointer to newly created queue.
+ */
+SaleQueue *saleQueue_new(size_t capacity, Inventory *inventory,
+        Sales *sales) {
+    size_t size = 2;
+    while (size < capacity)
+        size *= 2;
+
+    // Allocate queue and its slots to memory
+    SaleQueue *queue = (SaleQueue*)aligned_alloc(_Alignof(SaleQueue),
+            (sizeof(SaleQueue) + _Alignof(SaleQueue) - 1)
+            / _Alignof(SaleQueue) * _Alignof(SaleQueue));
+    SaleQueueSlot *slots = (SaleQueueSlot*)malloc(sizeof(SaleQueueSlot)
+            * size);
+    // Null check memory allocation
+    if (!queue || !slots) {
+        fprintf(stderr, "Error: Unable to allocate memory in "
+                "saleQueue_new().\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // Slot i is free for the producer claiming position i
+    for (size_t i = 0; i < size; i++)
+        atomic_init(&slots[i].sequence, i);
+    queue->slots    = slots;
+    queue->capacity = size;
+    queue->mask     = size - 1;
+    atomic_init(&queue->tail, 0);
+    queue->head     = 0;
+
+    queue->inventory = inventory;
+    queue->sales     = sales;
+    atomic_init(&queue->stop, 0);
+    pthread_mutex_init(&queue->lock, NULL);
+    pthread_cond_init(&queue->wake, NULL);
+    atomic_init(&queue->sleeping, 0);
+    atomic_init(&queue->applied, 0);
+    atomic_init(&queue->made, 0);
+
+    if (pthread_create(&queue->applier, NULL, saleQueue_apply, queue) != 0) {
+        fprintf(stderr, "Error: Unable to start thread in "
+                "saleQueue_new().\n");
+        exit(EXIT_FAILURE);
+    }
+
+    return queue;
+}
+
+/**
+ * Method to queue a sale without waiting. The ID is copied, so it need
+ * not stay valid. A sale whose ID does not fit in SALE_QUEUE_ID_BUFFER
+ * can not be in the inventory, so it is rejected at once.
+ * 
+ * @param  Pointer to queue.
+ * @param  Date of sale.
+ * @param  Char ID of stock item sold.
+ * @param  Integer Quantity of number of items sold.
+ * @param  Pointer to completion slot to set once sale is applied, or null.
+ * @return 1 if sale was queued, 0 if queue is full or -1 if sale was
+ *         rejected at once.
+ */
+int saleQueue_tryPush(SaleQueue *queue, Date date, const char *ID,
+        int quantity, SaleCompletion *completion) {
+    size_t length = strlen(ID);
+    if (length >= SALE_QUEUE_ID_BUFFER) {
+        if (completion)
+            atomic_store_explicit(&completion->status, SALE_REJECTED,
+                    memory_order_release);
+        return -1;
+    }
+
+    // Claim tail slot once applier has freed it
+    size_t position = atomic_load_explicit(&queue->tail,
+            memory_order_relaxed);
+    SaleQueueSlot *slot;
+    for (;;) {
+        slot = &queue->slots[position & queue->mask];
+        size_t sequence = atomic_load_explicit(&slot->sequence,
+                memory_order_acquire);
+
+        if (sequence == position) {
+            if (atomic_compare_exchange_weak_explicit(&queue->tail,
+                    &position, position + 1, memory_order_relaxed,
+                    memory_order_relaxed))
+                break;
+        }
+        // Slot still holds a sale from a lap ago, so queue is full
+        else if (sequence < position)
+            return 0;
+        else
+            position = atomic_load_explicit(&queue->tail,
+                    memory_order_relaxed);
+    }
+
+    // Fill slot then hand it to applier, waking it if it sleeps
+    slot->date       = date;
+    slot->quantity   = quantity;
+    slot->completion = completion;
+    memcpy(slot->ID, ID, length + 1);
+    atomic_store(&slot->sequence, position + 1);
+    if (atomic_load(&queue->sleeping))
+        saleQueue_wake(queue);
+
+    return 1;
+}
+
+/**
+ * Method to queue a sale, waiting while the queue is full. The ID is
+ * copied, so it need not stay valid.
+ * 
+ * @param Pointer to queue.
+ * @param Date of sale.
+ * @param Char ID of stock item sold.
+ * @param Integer Quantity of number of items sold.
+ * @param Pointer to completion slot to set once sale is applied, or null.
+ */
+void saleQueue_push(SaleQueue *queue, Date date, const char *ID,
+        int quantity, SaleCompletion *completion) {
+    while (saleQueue_tryPush(queue, date, ID, quantity, completion) == 0)
+        sched_yield();
+}
+
+/**
+ * Method to stop the applier thread once every sale already queued has
+ * been applied, and free the queue from memory. No sales may be pushed
+ * once stopping has begun.
+ * 
+ * @param Pointer to queue to be stopped and freed.
+ */
+void saleQueue_free(SaleQueue *queue) {
+    atomic_store(&queue->stop, 1);
+    saleQueue_wake(queue);
+    pthread_join(queue->applier, NULL);
+
+    pthread_mutex_destroy(&queue->lock);
+    pthread_cond_destroy(&queue->wake);
+    free(queue->slots);
+    free(queue);
+}
+
+/**
+ * Method to wait until the sale of a completion slot has been applied.
+ * 
+ * @param  Pointer to completion slot.
+ * @return SALE_ACCEPTED if sale was made or SALE_REJECTED if not.
+ */
+SaleStatus saleCompletion_wait(SaleCompletion *completion) {
+    SaleStatus status;
+    while ((status = saleCompletion_status(completion)) == SALE_PENDING)
+        sched_yield();
+
+    return status;
+}
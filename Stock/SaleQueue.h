@@ -0,0 +1,184 @@
+/* 
+ * File:   SaleQueue.h
+ * Author: Paulo Jorge
+ */
+
+#ifndef SALEQUEUE_H
+#define SALEQUEUE_H
+
+#include <stddef.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#include "Inventory.h"
+#include "Sales.h"
+#include "Date.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Buffer size for stock item IDs copied into the queue, including null
+ * terminator.
+ */
+#define SALE_QUEUE_ID_BUFFER 32
+
+/**
+ * Largest number of sales the applier takes from the queue at once.
+ */
+#define SALE_QUEUE_BATCH 1024
+
+/**
+ * Number of times in a row the applier finds the queue empty, yielding
+ * between each, before it sleeps until a sale is pushed.
+ */
+#define SALE_QUEUE_SPINS 64
+
+/**
+ * States of a completion slot.
+ */
+typedef enum SaleStatusEnum {
+    SALE_PENDING,
+    SALE_ACCEPTED,
+    SALE_REJECTED
+}
+SaleStatus;
+
+/**
+ * Completion slot a producer can pass with a sale to learn if it was made.
+ * It is set once the applier has applied the sale.
+ */
+typedef struct SaleCompletionStruct {
+    atomic_int status;
+}
+SaleCompletion;
+
+/**
+ * Slot of the queue ring. Its sequence number says if it is free for the
+ * producer claiming it or holds a sale ready for the applier.
+ */
+typedef struct SaleQueueSlotStruct {
+    atomic_size_t sequence;
+    Date date;
+    int quantity;
+    SaleCompletion *completion;
+    char ID[SALE_QUEUE_ID_BUFFER];
+}
+SaleQueueSlot;
+
+/**
+ * Bounded lock-free queue of sales from any number of producer threads,
+ * applied to a inventory and sales list in batches by a single applier
+ * thread with sales_addBatch(). Producers claim a slot with a compare and
+ * swap on the tail and never touch inventory or sales, so they only
+ * contend with each other on the tail. A producer waits while the queue
+ * is full. A applier that keeps finding the queue empty sleeps on wake,
+ * and the producer that next fills a slot signals it.
+ */
+typedef struct SaleQueueStruct {
+    SaleQueueSlot *slots;
+    // Capacity is a power of two, mask is capacity - 1
+    size_t capacity, mask;
+    // Next slot to claim, on its own cache line from the applier's head
+    _Alignas(64) atomic_size_t tail;
+    _Alignas(64) size_t head;
+    // Inventory and sales list sales are applied to
+    Inventory *inventory;
+    Sales *sales;
+    // Applier thread, stopping once queue is empty after stop is set
+    pthread_t applier;
+    atomic_int stop;
+    // Set by applier while it sleeps on wake, under lock
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    atomic_int sleeping;
+    // Number of sales applied and made
+    atomic_long applied, made;
+}
+SaleQueue;
+
+/**
+ * Method to allocate memory for a new queue and start its applier
+ * thread. Or generates error message if memory allocation fails or the
+ * thread can not be started and terminates program.
+ * 
+ * @param  Integer capacity, rounded up to a power of two.
+ * @param  Pointer to inventory containing stock items sold.
+ * @param  Pointer to sales list sales are appended to.
+ * @return Pointer to newly created queue.
+ */
+SaleQueue *saleQueue_new(size_t capacity, Inventory *inventory,
+        Sales *sales);
+
+/**
+ * Method to queue a sale without waiting. The ID is copied, so it need
+ * not stay valid. A sale whose ID does not fit in SALE_QUEUE_ID_BUFFER
+ * can not be in the inventory, so it is rejected at once.
+ * 
+ * @param  Pointer to queue.
+ * @param  Date of sale.
+ * @param  Char ID of stock item sold.
+ * @param  Integer Quantity of number of items sold.
+ * @param  Pointer to completion slot to set once sale is applied, or null.
+ * @return 1 if sale was queued, 0 if queue is full or -1 if sale was
+ *         rejected at once.
+ */
+int saleQueue_tryPush(SaleQueue *queue, Date date, const char *ID,
+        int quantity, SaleCompletion *completion);
+
+/**
+ * Method to queue a sale, waiting while the queue is full. The ID is
+ * copied, so it need not stay valid.
+ * 
+ * @param Pointer to queue.
+ * @param Date of sale.
+ * @param Char ID of stock item sold.
+ * @param Integer Quantity of number of items sold.
+ * @param Pointer to completion slot to set once sale is applied, or null.
+ */
+void saleQueue_push(SaleQueue *queue, Date date, const char *ID,
+        int quantity, SaleCompletion *completion);
+
+/**
+ * Method to stop the applier thread once every sale already queued has
+ * been applied, and free the queue from memory. No sales may be pushed
+ * once stopping has begun.
+ * 
+ * @param Pointer to queue to be stopped and freed.
+ */
+void saleQueue_free(SaleQueue *queue);
+
+/**
+ * Method to reset a completion slot before it is passed with a sale.
+ * 
+ * @param Pointer to completion slot.
+ */
+static inline void saleCompletion_init(SaleCompletion *completion) {
+    atomic_init(&completion->status, SALE_PENDING);
+}
+
+/**
+ * Get method to get the status of a completion slot without waiting.
+ * 
+ * @param  Pointer to completion slot.
+ * @return SALE_PENDING, or SALE_ACCEPTED or SALE_REJECTED once applied.
+ */
+static inline SaleStatus saleCompletion_status(SaleCompletion *completion) {
+    return (SaleStatus)atomic_load_explicit(&completion->status,
+            memory_order_acquire);
+}
+
+/**
+ * Method to wait until the sale of a completion slot has been applied.
+ * 
+ * @param  Pointer to completion slot.
+ * @return SALE_ACCEPTED if sale was made or SALE_REJECTED if not.
+ */
+SaleStatus saleCompletion_wait(SaleCompletion *completion);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SALEQUEUE_H */
@@ -5,124 +5,301 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 
 #include "StockItem.h"
 #include "Inventory.h"
 #include "Sales.h"
 
+// Number of records allocated for a new sales list, including end record
+#define SALES_MIN_CAPACITY 64
+
+/**
+ * Method to grow the records of a sales list to hold at least a number of
+ * records, including the end record. Or generates error message if memory
+ * allocation fails and terminates program.
+ * 
+ * @param Pointer to sales list to be grown.
+ * @param Integer number of records needed.
+ */
+static void sales_grow(Sales* sales, int capacity) {
+    if (capacity <= sales->capacity)
+        return;
+
+    // Double capacity so appends take amortised constant time
+    int newCapacity = sales->capacity;
+    while (newCapacity < capacity)
+        newCapacity *= 2;
+
+    SalesRecord *records = (SalesRecord*)realloc(sales->records,
+            sizeof(SalesRecord) * newCapacity);
+    // Null check memory allocation
+    if (!records) {
+        fprintf(stderr, "Error: Unable to allocate memory in "
+                "sales_grow().\n");
+        exit(EXIT_FAILURE);
+    }
+
+    sales->records  = records;
+    sales->capacity = newCapacity;
+}
+
 /**
- * Method to allocate memory for a new sales list of sales. Or 
+ * Method to allocate memory for a new sales list of sales. Or
  * generates error message if memory allocation fails and terminates program.
  * 
  * @return Pointer to newly created sales.
  */
 Sales* sales_new() {
-    // Allocate sales to memory
+    // Allocate sales and its records to memory
     Sales* sales = (Sales*)malloc(sizeof(Sales));
+    SalesRecord *records = (SalesRecord*)malloc(sizeof(SalesRecord)
+            * SALES_MIN_CAPACITY);
     // Null check memory allocation
-    if (!sales) {
+    if (!sales || !records) {
         fprintf(stderr, "Error: Unable to allocate memory in "
                 "sales_new().\n");
         exit(EXIT_FAILURE);
     }
 
-    // As empty, default first and last to null
-    sales->first = NULL;
-    sales->last  = NULL;
-    
+    // As empty, only contains end record
+    sales->records  = records;
+    sales->count    = 0;
+    sales->capacity = SALES_MIN_CAPACITY;
+    sales->modifications = 0;
+    sales->records[0].item = NULL;
+
     return sales;
 }
 
 /**
- * Method to append a new sale to the tail of a sales list. 
- * Or generates error message if memory allocation fails and terminates 
- * program.
+ * Method to append a new sale to the tail of a sales list, in amortised
+ * constant time. Or generates error message if memory allocation fails and
+ * terminates program.
  * 
- * @param Pointer to sales list of which will be appended to.
- * @param Pointer to stock item sold.
- * @param Pointer to date containing date.
- * @param Char ID of stock item sold.
- * @param Integer Quantity of number of items sold.
+ * @param  Pointer to sales list of which will be appended to.
+ * @param  Pointer to inventory containing stock item sold.
+ * @param  Date of sale.
+ * @param  Char ID of stock item sold.
+ * @param  Integer Quantity of number of items sold.
+ * @return 1 if sale was made or 0 if item was not found or has
+ *         insufficient stock.
  */
-void sales_add(Sales* sales, Inventory* inventory, Date *date, char *ID, 
+int sales_add(Sales* sales, Inventory* inventory, Date date, char *ID,
         int quantity) {
-    // Allocate node to memory
-    SalesNode* node = (SalesNode*)malloc(sizeof(SalesNode));
+    // Find item sold
+    StockItem *item = inventory_find(inventory, ID);
+
+    return item ? sales_addItem(sales, item, date, quantity) : 0;
+}
+
+/**
+ * Method to append a new sale of a stock item already found to the tail
+ * of a sales list. Or generates error message if memory allocation fails
+ * and terminates program.
+ * 
+ * @param  Pointer to sales list of which will be appended to.
+ * @param  Pointer to stock item sold.
+ * @param  Date of sale.
+ * @param  Integer Quantity of number of items sold.
+ * @return 1 if sale was made or 0 if item has insufficient stock.
+ */
+int sales_addItem(Sales* sales, StockItem *item, Date date, int quantity) {
+    // Only allow sale if stock item has sufficient stock
+    if (stockItem_Sell(item, quantity) == 0)
+        return 0;
+
+    sales_append(sales, item, date, quantity);
+    return 1;
+}
+
+/**
+ * Method to make a batch of sales in order and append those made to the 
+ * tail of a sales list, with the same results as calling sales_add() on 
+ * each. IDs are all looked up first, repeating the previous lookup when a 
+ * sale is of the same ID as the sale before it, and consecutive sales of 
+ * the same stock item take its stock at once. The sales list is grown at 
+ * most once. Or generates error message if memory allocation fails and 
+ * terminates program.
+ * 
+ * @param  Pointer to sales list of which will be appended to.
+ * @param  Pointer to inventory containing stock items sold.
+ * @param  Array of sales to be made.
+ * @param  Integer number of sales.
+ * @param  Array to set to 1 for each sale made or 0 if item was not found 
+ *         or has insufficient stock, or null.
+ * @return Integer number of sales made.
+ */
+int sales_addBatch(Sales* sales, Inventory* inventory, 
+        const SaleRequest *requests, int count, unsigned char *accepted) {
+    if (count <= 0)
+        return 0;
+    
+    // Stock items and quantities of sales, and results if none are wanted
+    StockItem **items = (StockItem**)malloc(sizeof(StockItem*) * count);
+    int *quantities = (int*)malloc(sizeof(int) * count);
+    unsigned char *results = accepted ? accepted 
+            : (unsigned char*)malloc(count);
     // Null check memory allocation
-    if (!node) {
-        fprintf(stderr, "Error: Unable to allocate memory "
-                "in sales_add().\n");
+    if (!items || !quantities || !results) {
+        fprintf(stderr, "Error: Unable to allocate memory in "
+                "sales_addBatch().\n");
         exit(EXIT_FAILURE);
     }
     
-    // Find item sold
-    StockItem *item = inventory_find(inventory, ID);
+    // Look up all IDs, reusing lookup of a repeated ID
+    for (int i = 0; i < count; i++) {
+        items[i] = ((i > 0) && (strcmp(requests[i].ID, requests[i - 1].ID) 
+                == 0)) ? items[i - 1] 
+                : inventory_find(inventory, requests[i].ID);
+        quantities[i] = requests[i].quantity;
+    }
     
-    // Only allow sale if stock item exists and stock item has sufficient stock
-    if(item && (stockItem_Sell(item, quantity) == 1)) {
-        // Pass in sales information
-        node->item     = item;
-        node->date     = date;
-        node->ID       = ID;
-        node->quantity = quantity;
-        node->next     = NULL;
-
-        // If sales list is empty, set this as first and last
-        if (sales->last == NULL)
-            sales->first = sales->last = node;
-        // Else add this to tail of inventory
+    // Sell each run of sales of the same stock item at once
+    for (int start = 0, end; start < count; start = end) {
+        for (end = start + 1; (end < count) && (items[end] == items[start]); 
+                end++);
+        
+        if (items[start])
+            stockItem_SellEach(items[start], quantities + start, 
+                    end - start, results + start);
         else
-            sales->last = sales->last->next = node;
+            memset(results + start, 0, end - start);
     }
-    // Else free node from memory as it was unassigned
-    else
-        sales_free(node);
+    
+    // Append sales made, growing sales list once
+    sales_reserve(sales, count);
+    SalesRecord *record = sales->records + sales->count;
+    for (int i = 0; i < count; i++)
+        if (results[i]) {
+            record->item     = items[i];
+            record->date     = requests[i].date;
+            record->quantity = requests[i].quantity;
+            record++;
+        }
+    int made = (int)(record - (sales->records + sales->count));
+    sales->count += made;
+    
+    // Move end record along
+    record->item = NULL;
+    
+    free(items);
+    free(quantities);
+    if (!accepted)
+        free(results);
+    
+    return made;
 }
 
 /**
- * Method to append a new sale to the head of a sales list. 
- * Or generates error message if memory allocation fails and terminates 
+ * Method to append a sale that has already been applied to its stock item
+ * to the tail of a sales list, without selling any stock. Used when
+ * restoring sales whose quantities are already reflected in stock. Or
+ * generates error message if memory allocation fails and terminates
  * program.
  * 
  * @param Pointer to sales list of which will be appended to.
  * @param Pointer to stock item sold.
- * @param Pointer to date containing date.
+ * @param Date of sale.
+ * @param Integer Quantity of number of items sold.
+ */
+void sales_append(Sales* sales, StockItem *item, Date date, int quantity) {
+    // Make room for this record and the end record
+    sales_grow(sales, sales->count + 2);
+
+    // Pass in sales information
+    SalesRecord *record = sales->records + sales->count++;
+    record->item     = item;
+    record->date     = date;
+    record->quantity = quantity;
+
+    // Move end record along
+    record[1].item = NULL;
+}
+
+/**
+ * Method to append a new sale to the head of a sales list, moving all
+ * existing sales along one record. Or generates error message if memory
+ * allocation fails and terminates program.
+ * 
+ * @param Pointer to sales list of which will be appended to.
+ * @param Pointer to stock item sold.
+ * @param Date of sale.
  * @param Char ID of stock item sold.
  * @param Integer Quantity of number of items sold.
  */
-void sales_insert(Sales* sales, Inventory* inventory, Date *date, char *ID, 
+void sales_insert(Sales* sales, Inventory* inventory, Date date, char *ID,
         int quantity) {
-    // Allocate node to memory
-    SalesNode* node = (SalesNode*)malloc(sizeof(SalesNode));
-    // Null check memory allocation
-    if (!node) {
-        fprintf(stderr, "Error: Unable to allocate memory "
-                "in sales_insert().\n");
-        exit(EXIT_FAILURE);
-    }
-    
     // Find item sold
     StockItem *item = inventory_find(inventory, ID);
-    
+
     // Only allow sale if stock item exists and stock item has sufficient stock
     if(item && (stockItem_Sell(item, quantity) == 1)) {
+        // Make room at head, moving end record along with the rest
+        sales_grow(sales, sales->count + 2);
+        memmove(sales->records + 1, sales->records,
+                sizeof(SalesRecord) * (sales->count + 1));
+        sales->count++;
+        sales->modifications++;
+
         // Pass in sales information
-        node->item     = item;
-        node->date     = date;
-        node->ID       = ID;
-        node->quantity = quantity;
-        node->next     = sales->first;
-
-        // If sales list is empty, set this as first and last
-        if (sales->last == NULL)
-            sales->first = sales->last = node;
-        // Else add to head of the sales list
-        else
-            sales->first = node;
+        sales->records[0].item     = item;
+        sales->records[0].date     = date;
+        sales->records[0].quantity = quantity;
     }
-    // Else free node from memory as it was unassigned
-    else
-        sales_free(node);
+}
+
+/**
+ * Method to make sure a sales list has room for a number of further sales
+ * without growing. Or generates error message if memory allocation fails
+ * and terminates program.
+ * 
+ * @param Pointer to sales list to be grown.
+ * @param Integer number of sales that will be added.
+ */
+void sales_reserve(Sales* sales, int count) {
+    sales_grow(sales, sales->count + count + 1);
+}
+
+/**
+ * Method to make sure a sales list has room for a number of further sales
+ * without growing, moving its records to a new array if it must grow and
+ * leaving the old array allocated for readers that may still be using it.
+ * Or generates error message if memory allocation fails and terminates
+ * program.
+ * 
+ * @param  Pointer to sales list to be grown.
+ * @param  Integer number of sales that will be added.
+ * @return Pointer to old records, to be freed by the caller once no longer
+ *         read, or null if the sales list did not need to grow.
+ */
+SalesRecord *sales_reserveDetached(Sales* sales, int count) {
+    int capacity = sales->count + count + 1;
+    if (capacity <= sales->capacity)
+        return NULL;
+
+    // Double capacity so appends take amortised constant time
+    int newCapacity = sales->capacity;
+    while (newCapacity < capacity)
+        newCapacity *= 2;
+
+    SalesRecord *records = (SalesRecord*)malloc(sizeof(SalesRecord)
+            * newCapacity);
+    // Null check memory allocation
+    if (!records) {
+        fprintf(stderr, "Error: Unable to allocate memory in "
+                "sales_reserveDetached().\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // Copy records and end record, old records are left untouched
+    memcpy(records, sales->records, sizeof(SalesRecord) * (sales->count + 1));
+    SalesRecord *old = sales->records;
+    sales->records  = records;
+    sales->capacity = newCapacity;
+
+    return old;
 }
 
 /**
@@ -132,13 +309,7 @@ void sales_insert(Sales* sales, Inventory* inventory, Date *date, char *ID,
  * @return Integer value of number of elements within sales.
  */
 int sales_count(const Sales* sales) {
-    int count = 0;
-    // Count number of nodes in inventory
-    for (SalesNode* node = sales->first; node != NULL; 
-            node = node->next)
-        count++;
-    
-    return count;
+    return sales->count;
 }
 
 /**
@@ -148,125 +319,150 @@ int sales_count(const Sales* sales) {
  */
 void sales_removeTail(Sales* sales)  {
     // Null check if sales list is empty
-    if (sales->first == NULL) {
+    if (sales->count == 0) {
         fprintf(stderr, "Error: Attempting to remove the tail from an empty "
                 "sales list in sales_removeTail().\n");
         exit(EXIT_FAILURE);
     }
-    
-    // Get tail of sales list
-    SalesNode* tail = sales->last;
-    
-    // If sales only has one item, set first and last to null
-    if (sales->first == sales->last)
-        sales->first = sales->last = NULL;
-    else {
-        SalesNode* node;
-        // Find the second to last node
-        for (node = sales->first; node->next != tail; node = node->next);
- 
-        // Set this node as last
-        sales->last       = node;
-        // Remove previously last node
-        sales->last->next = NULL;
-    }
-    
-    // Free tail from memory
-    free(tail);
+
+    // Tail becomes the end record
+    sales->records[--sales->count].item = NULL;
+    sales->modifications++;
 }
 
 /**
- * Method to remove the a sale at the head of a sales list.
+ * Method to remove the a sale at the head of a sales list, moving all
+ * remaining sales back one record.
  * 
  * @param  Pointer to the sales list where the head will be removed.
  */
 void sales_removeHead(Sales* sales) {
         // Null check if sales is empty
-    if (sales->first == NULL) {
+    if (sales->count == 0) {
         fprintf(stderr, "Error: Attempting to remove the head from an empty "
                 "inventory in sales_removeHead().\n");
         exit(EXIT_FAILURE);
     }
-    
-    // Get head of sales list
-    SalesNode* head = sales->first;
-    
-    // If sales only has one node, set first and last to null
-    if (sales->first == sales->last)
-        sales->first = sales->last = NULL;
-    // Else set previously second node to first
-    else
-        sales->first = sales->first->next;  
-        
-    // Free head from memory
-    free(head);
+
+    // Move remaining records and end record back over head
+    memmove(sales->records, sales->records + 1,
+            sizeof(SalesRecord) * sales->count);
+    sales->count--;
+    sales->modifications++;
 }
 
 /**
  * Method to clear all the elements within a sales list structure.
- *  
+ * 
  * @param Pointer to sales list to be cleared.
  */
-void sales_clear(Sales* sales) { 
-    // While sales is not empty remove from head to tail each
-    // node one by one
-    while (sales->first != NULL) {
-        SalesNode* node = sales->first;
-        sales->first = node->next;
-        
-        // Free node from memory
-        free(node);
-    }
+void sales_clear(Sales* sales) {
+    // Only the end record remains, records are kept for reuse
+    sales->count = 0;
+    sales->records[0].item = NULL;
+    sales->modifications++;
+}
+
+/**
+ * Get method to get ID of a sales record.
+ * 
+ * @param  Pointer to sales record containing ID.
+ * @return ID char.
+ */
+char *sales_getID(const SalesRecord* record) {
+    return stockItem_getID(record->item);
+}
+
+/**
+ * Get method to get date of a sales record.
+ * 
+ * @param  Pointer to sales record containing date.
+ * @return Date of sale.
+ */
+Date sales_getDate(const SalesRecord* record) {
+    return record->date;
 }
 
 /**
- * Get method to get ID of a sales node.
+ * Get method to get quantity of a sales record.
  * 
- * @param  Pointer to sales node containing ID.
- * @return ID char. 
+ * @param  Pointer to sales record containing quantity.
+ * @return Integer quantity value.
  */
-char *sales_getID(const SalesNode* node) {
-    return node->ID;
+int sales_getQuantity(const SalesRecord* record) {
+    return record->quantity;
 }
 
 /**
- * Get method to get quantity of a sales node.
+ * Get method to get total cost of a sales record.
  * 
- * @param  Pointer to sales node containing quantity.
- * @return Integer quantity value. 
+ * @param  Pointer to sales record containing quantity and
+ *         reference to stock item sold.
+ * @return Total cost in pennies.
  */
-int sales_getQuantity(const SalesNode* node) {
-    return node->quantity;
+Money sales_getTotal(const SalesRecord* record) {
+    return money_multiply(stockItem_getPennies(record->item), 
+            record->quantity);
 }
 
 /**
- * Get method to get total cost of a sales node.
+ * Get method to get total cost of a sales record in pounds. Kept for 
+ * compatibility, costs should be read with sales_getTotal().
  * 
- * @param  Pointer to sales node containing quantity and
+ * @param  Pointer to sales record containing quantity and
  *         reference to stock item sold.
- * @return Float total cost value in pounds. 
+ * @return Float total cost value in pounds.
  */
-float sales_getCost(const SalesNode* node) {
-    return stockItem_getPrice(node->item) * (float)node->quantity;
+float sales_getCost(const SalesRecord* record) {
+    return money_toPounds(sales_getTotal(record));
 }
 
 /**
- * Method to print a specific sales node to the console.
+ * Method to write a specific sales record to a report.
  * 
- * @param Pointer to sales node to be printed.
+ * @param Pointer to report writer.
+ * @param Pointer to sales record to be written.
  */
-void sales_printSale(const SalesNode *node) {
-    // Print sale information
-    printf("\nDate:           %s\n"
-             "ID:             %s\n"
-             "Quantity:       %d\n"
-             "Price per item: £%.2f\n"
-             "Cost of Sale:   £%.2f\n",
-             date_getDate(node->date), 
-             sales_getID(node), 
-             sales_getQuantity(node), 
-             stockItem_getPrice(node->item),
-             sales_getCost(node));
+void sales_writeSale(Report *report, const SalesRecord *record) {
+    report_string(report, "\nDate:           ");
+    report_date(report, record->date);
+    report_string(report, "\nID:             ");
+    report_string(report, sales_getID(record));
+    report_string(report, "\nQuantity:       ");
+    report_int(report, sales_getQuantity(record));
+    report_string(report, "\nPrice per item: £");
+    report_money(report, stockItem_getPennies(record->item));
+    report_string(report, "\nCost of Sale:   £");
+    report_money(report, sales_getTotal(record));
+    report_string(report, "\n");
+}
+
+/**
+ * Method to write all elements within a sales list to a report.
+ * 
+ * @param Pointer to report writer.
+ * @param Pointer to sales list to be written.
+ */
+void sales_write(Report *report, const Sales* sales) {
+    // Loop and write all records if sales list is not empty
+    if (sales->count > 0)
+        for (int i = 0; i < sales->count; i++)
+            sales_writeSale(report, sales->records + i);
+    // Else write empty message
+    else
+        report_string(report, "No sale has been made.\n");
+}
+
+/**
+ * Method to print a specific sales record to the console.
+ * 
+ * @param Pointer to sales record to be printed.
+ */
+void sales_printSale(const SalesRecord *record) {
+    Report report;
+    report_init(&report, STDOUT_FILENO);
+    sales_writeSale(&report, record);
+    report_flush(&report);
 }
 
 /**
@@ -275,25 +471,10 @@ void sales_printSale(const SalesNode *node) {
  * @param Pointer to sales list to be printed.
  */
 void sales_print(const Sales* sales)  {
-    // Loop and print all nodes if sales list is not empty
-    if (sales->first != NULL)
-        for(SalesNode* node = sales->first; node != NULL; 
-                node = node->next) {
-            // Print sale information
-            printf("\nDate:           %s\n"
-                     "ID:             %s\n"
-                     "Quantity:       %d\n"
-                     "Price per item: £%.2f\n"
-                     "Cost of Sale:   £%.2f\n",
-                     date_getDate(node->date), 
-                     sales_getID(node), 
-                     sales_getQuantity(node), 
-                     stockItem_getPrice(node->item),
-                     sales_getCost(node));
-        }   
-    // Else display empty message to console
-    else
-        printf("No sale has been made.\n");
+    Report report;
+    report_init(&report, STDOUT_FILENO);
+    sales_write(&report, sales);
+    report_flush(&report);
 }
 
 /**
@@ -302,8 +483,8 @@ void sales_print(const Sales* sales)  {
  * @param Pointer to sales list to which will be freed from memory.
  */
 void sales_free(Sales* sales){
-    // Free all nodes from sales before freeing sales list
-    sales_clear(sales);
-    
+    // Free records before freeing sales list
+    free(sales->records);
+
     free(sales);
-}
\ No newline at end of file
+}
@@ -9,73 +9,90 @@
 #include "StockItem.h"
 #include "Date.h"
 #include "Inventory.h"
+#include "Report.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 /**
- * Node structure defining and containing information about a sale.
+ * Record structure defining and containing information about a sale. 
+ * Records are stored packed in a array so a sale needs no allocations of 
+ * its own.
  */
-typedef struct SalesNodeStruct {
+typedef struct SalesRecordStruct {
     StockItem *item;
-    Date *date;
-    char *ID;
+    Date date;
     int quantity;
-    struct SalesNodeStruct* next;
 }
-SalesNode;
+SalesRecord;
 
 /**
- * Sales type structure defining and containing node information.
+ * Structure defining a sale to be made by sales_addBatch(), by ID of the
+ * stock item sold.
+ */
+typedef struct SaleRequestStruct {
+    Date date;
+    const char *ID;
+    int quantity;
+}
+SaleRequest;
+
+/**
+ * Sales type structure defining and containing sales records. Records are
+ * followed by a end record with a null stock item, so the array always has
+ * room for one more record than is counted.
  */
 typedef struct SalesStruct {
-    SalesNode* first;
-    SalesNode* last;
+    SalesRecord *records;
+    int count, capacity;
+    // Number of times sales have been inserted or removed, appends are not
+    // counted so they can be caught up with from count alone
+    unsigned long modifications;
 }
 Sales;
 
 /**
- * Definition for iterator type used to iterate through sales list nodes.
+ * Definition for iterator type used to iterate through sales records.
  */
-typedef SalesNode* SalesIterator;
+typedef SalesRecord* SalesIterator;
 
 /**
- * Method to get the first node in a sales list.
+ * Method to get the first record in a sales list.
  * 
- * @param  Pointer to sales to get first node from.
- * @return Node of first item in sales.
+ * @param  Pointer to sales to get first record from.
+ * @return Record of first sale, or null if sales is empty.
  */
 static inline SalesIterator sales_first(const Sales *sales) {
-    return sales->first;
+    return sales->count ? sales->records : NULL;
 }
 
 /**
- * Method to get the last node in a sales list.
+ * Method to get the last record in a sales list.
  * 
- * @param  Pointer to sales to get last node from.
- * @return Node of last item in sales.
+ * @param  Pointer to sales to get last record from.
+ * @return Record of last sale, or null if sales is empty.
  */
 static inline SalesIterator sales_last(const Sales *sales) {
-    return sales->last;
+    return sales->count ? sales->records + sales->count - 1 : NULL;
 }
 
 /**
- * Method to get the next node.
+ * Method to get the next record.
  * 
  * @param  Current value of iterator.
- * @return Next node in sales list.
+ * @return Next record in sales list, or null if at the end record.
  */
 static inline SalesIterator sales_iteratorNext
     (const SalesIterator i) {
-    return i->next;
+    return i[1].item ? i + 1 : NULL;
 }
 
 /**
- * Method to get the current node of the iterator.
+ * Method to get the current record of the iterator.
  * 
  * @param  Iterator to be checked.
- * @return Current node of iterator.
+ * @return Current record of iterator.
  */
 static inline SalesIterator sales_iteratorGetCurrent
     (const SalesIterator i) {
@@ -91,33 +108,106 @@ static inline SalesIterator sales_iteratorGetCurrent
 Sales* sales_new();
 
 /**
- * Method to append a new sale to the tail of a sales list. 
- * Or generates error message if memory allocation fails and terminates 
+ * Method to append a new sale to the tail of a sales list, in amortised
+ * constant time. Or generates error message if memory allocation fails
+ * and terminates program.
+ * 
+ * @param  Pointer to sales list of which will be appended to.
+ * @param  Pointer to inventory containing stock item sold.
+ * @param  Date of sale.
+ * @param  Char ID of stock item sold.
+ * @param  Integer Quantity of number of items sold.
+ * @return 1 if sale was made or 0 if item was not found or has 
+ *         insufficient stock.
+ */
+int sales_add(Sales* sales, Inventory* inventory, Date date, char *ID, 
+        int quantity);
+
+/**
+ * Method to append a new sale of a stock item already found to the tail 
+ * of a sales list. Or generates error message if memory allocation fails 
+ * and terminates program.
+ * 
+ * @param  Pointer to sales list of which will be appended to.
+ * @param  Pointer to stock item sold.
+ * @param  Date of sale.
+ * @param  Integer Quantity of number of items sold.
+ * @return 1 if sale was made or 0 if item has insufficient stock.
+ */
+int sales_addItem(Sales* sales, StockItem *item, Date date, int quantity);
+
+/**
+ * Method to make a batch of sales in order and append those made to the 
+ * tail of a sales list, with the same results as calling sales_add() on 
+ * each. IDs are all looked up first, repeating the previous lookup when a 
+ * sale is of the same ID as the sale before it, and consecutive sales of 
+ * the same stock item take its stock at once. The sales list is grown at 
+ * most once. Or generates error message if memory allocation fails and 
+ * terminates program.
+ * 
+ * @param  Pointer to sales list of which will be appended to.
+ * @param  Pointer to inventory containing stock items sold.
+ * @param  Array of sales to be made.
+ * @param  Integer number of sales.
+ * @param  Array to set to 1 for each sale made or 0 if item was not found 
+ *         or has insufficient stock, or null.
+ * @return Integer number of sales made.
+ */
+int sales_addBatch(Sales* sales, Inventory* inventory, 
+        const SaleRequest *requests, int count, unsigned char *accepted);
+
+/**
+ * Method to append a sale that has already been applied to its stock item
+ * to the tail of a sales list, without selling any stock. Used when 
+ * restoring sales whose quantities are already reflected in stock. Or 
+ * generates error message if memory allocation fails and terminates 
  * program.
  * 
  * @param Pointer to sales list of which will be appended to.
  * @param Pointer to stock item sold.
- * @param Pointer to date containing date.
- * @param Char ID of stock item sold.
+ * @param Date of sale.
  * @param Integer Quantity of number of items sold.
  */
-void sales_add(Sales* sales, Inventory* inventory, Date *date, char *ID, 
-        int quantity);
+void sales_append(Sales* sales, StockItem *item, Date date, int quantity);
 
 /**
- * Method to append a new sale to the head of a sales list. 
- * Or generates error message if memory allocation fails and terminates 
- * program.
+ * Method to append a new sale to the head of a sales list, moving all 
+ * existing sales along one record. Or generates error message if memory
+ * allocation fails and terminates program.
  * 
  * @param Pointer to sales list of which will be appended to.
  * @param Pointer to stock item sold.
- * @param Pointer to date containing date.
+ * @param Date of sale.
  * @param Char ID of stock item sold.
  * @param Integer Quantity of number of items sold.
  */
-void sales_insert(Sales* sales, Inventory* inventory, Date *date, char *ID, 
+void sales_insert(Sales* sales, Inventory* inventory, Date date, char *ID, 
         int quantity);
 
+/**
+ * Method to make sure a sales list has room for a number of further sales
+ * without growing. Or generates error message if memory allocation fails 
+ * and terminates program.
+ * 
+ * @param Pointer to sales list to be grown.
+ * @param Integer number of sales that will be added.
+ */
+void sales_reserve(Sales* sales, int count);
+
+/**
+ * Method to make sure a sales list has room for a number of further sales
+ * without growing, moving its records to a new array if it must grow and
+ * leaving the old array allocated for readers that may still be using it.
+ * Or generates error message if memory allocation fails and terminates
+ * program.
+ * 
+ * @param  Pointer to sales list to be grown.
+ * @param  Integer number of sales that will be added.
+ * @return Pointer to old records, to be freed by the caller once no longer
+ *         read, or null if the sales list did not need to grow.
+ */
+SalesRecord *sales_reserveDetached(Sales* sales, int count);
+
 /**
  * Method to return the number of sales currently stored in a sales list.
  * 
@@ -134,7 +224,8 @@ int sales_count(const Sales* sales);
 void sales_removeTail(Sales* sales);
 
 /**
- * Method to remove a sale at the head of a sales list.
+ * Method to remove a sale at the head of a sales list, moving all 
+ * remaining sales back one record.
  * 
  * @param  Pointer to the sales list where the head will be removed.
  */
@@ -148,36 +239,70 @@ void sales_removeHead(Sales* sales);
 void sales_clear(Sales* sales);
 
 /**
- * Get method to get ID of a sales node.
+ * Get method to get ID of a sales record.
  * 
- * @param  Pointer to sales node containing ID.
+ * @param  Pointer to sales record containing ID.
  * @return ID char. 
  */
-char *sales_getID(const SalesNode* node);
+char *sales_getID(const SalesRecord* record);
 
 /**
- * Get method to get quantity of a sales node.
+ * Get method to get date of a sales record.
  * 
- * @param  Pointer to sales node containing quantity.
+ * @param  Pointer to sales record containing date.
+ * @return Date of sale. 
+ */
+Date sales_getDate(const SalesRecord* record);
+
+/**
+ * Get method to get quantity of a sales record.
+ * 
+ * @param  Pointer to sales record containing quantity.
  * @return Integer quantity value. 
  */
-int sales_getQuantity(const SalesNode* node);
+int sales_getQuantity(const SalesRecord* record);
 
 /**
- * Get method to get total cost of a sales node.
+ * Get method to get total cost of a sales record.
  * 
- * @param  Pointer to sales node containing quantity and
+ * @param  Pointer to sales record containing quantity and
+ *         reference to stock item sold.
+ * @return Total cost in pennies. 
+ */
+Money sales_getTotal(const SalesRecord* record);
+
+/**
+ * Get method to get total cost of a sales record in pounds. Kept for 
+ * compatibility, costs should be read with sales_getTotal().
+ * 
+ * @param  Pointer to sales record containing quantity and
  *         reference to stock item sold.
  * @return Float total cost value in pounds. 
  */
-float sales_getCost(const SalesNode* node);
+float sales_getCost(const SalesRecord* record);
+
+/**
+ * Method to write a specific sales record to a report.
+ * 
+ * @param Pointer to report writer.
+ * @param Pointer to sales record to be written.
+ */
+void sales_writeSale(Report *report, const SalesRecord *record);
+
+/**
+ * Method to write all elements within a sales list to a report.
+ * 
+ * @param Pointer to report writer.
+ * @param Pointer to sales list to be written.
+ */
+void sales_write(Report *report, const Sales* sales);
 
 /**
- * Method to print a specific sales node to the console.
+ * Method to print a specific sales record to the console.
  * 
- * @param Pointer to sales node to be printed.
+ * @param Pointer to sales record to be printed.
  */
-void sales_printSale(const SalesNode *node);
+void sales_printSale(const SalesRecord *record);
 
 /**
  * Method to print all elements within a sales list to the console.
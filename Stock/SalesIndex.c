@@ -0,0 +1,197 @@
+/* 
+ * File:   SalesIndex.c
+ * Author: Paulo Jorge
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SalesIndex.h"
+#include "StockItem.h"
+
+/**
+ * Method to allocate memory for a new index over a sales list, built in
+ * time proportional to the number of sales and days covered. The index
+ * must be rebuilt with salesIndex_rebuild() once sales have changed. Or
+ * generates error message if memory allocation fails and terminates
+ * program.
+ * 
+ * @param  Pointer to sales list to be indexed.
+ * @return Pointer to newly created index.
+ */
+SalesIndex *salesIndex_new(const Sales *sales) {
+    // Allocate index to memory
+    SalesIndex *index = (SalesIndex*)malloc(sizeof(SalesIndex));
+    // Null check memory allocation
+    if (!index) {
+        fprintf(stderr, "Error: Unable to allocate memory in "
+                "salesIndex_new().\n");
+        exit(EXIT_FAILURE);
+    }
+
+    index->sales     = sales;
+    index->offsets   = NULL;
+    index->positions = NULL;
+    salesIndex_rebuild(index);
+
+    return index;
+}
+
+/**
+ * Method to rebuild a index so it covers the current sales of its sales
+ * list. Or generates error message if memory allocation fails and
+ * terminates program.
+ * 
+ * @param Pointer to index to be rebuilt.
+ */
+void salesIndex_rebuild(SalesIndex *index) {
+    const SalesRecord *records = index->sales->records;
+    int count = index->sales->count;
+
+    // Find range of days covered
+    Date first = DATE_NONE, last = DATE_NONE;
+    for (int i = 0; i < count; i++) {
+        if ((first == DATE_NONE) || (records[i].date < first))
+            first = records[i].date;
+        if ((last == DATE_NONE) || (records[i].date > last))
+            last = records[i].date;
+    }
+    index->first = first;
+    index->days  = count ? date_difference(first, last) + 1 : 0;
+
+    free(index->offsets);
+    free(index->positions);
+    index->offsets   = (int*)calloc(index->days + 1, sizeof(int));
+    index->positions = (int*)malloc(sizeof(int) * (count ? count : 1));
+    // Null check memory allocation
+    if (!index->offsets || !index->positions) {
+        fprintf(stderr, "Error: Unable to allocate memory in "
+                "salesIndex_rebuild().\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // Count sales of each day, then turn counts into start of each day
+    for (int i = 0; i < count; i++)
+        index->offsets[date_difference(first, records[i].date) + 1]++;
+    for (int day = 0; day < index->days; day++)
+        index->offsets[day + 1] += index->offsets[day];
+
+    // Place each sale at the start of its day, moving the start along as a
+    // cursor, then move starts back to where each day begins
+    for (int i = 0; i < count; i++)
+        index->positions[index->offsets[date_difference(first,
+                records[i].date)]++] = i;
+    for (int day = index->days; day > 0; day--)
+        index->offsets[day] = index->offsets[day - 1];
+    index->offsets[0] = 0;
+}
+
+/**
+ * Method to find the start and end of a date range within a index.
+ * 
+ * @param Pointer to index to be searched.
+ * @param Date of first day of range.
+ * @param Date of last day of range, inclusive.
+ * @param Pointer to where start within positions will be stored.
+ * @param Pointer to where end within positions will be stored.
+ */
+static void salesIndex_bounds(const SalesIndex *index, Date from, Date to,
+        int *start, int *end) {
+    // Clamp range to days covered
+    int firstDay = (index->days > 0) ? date_difference(index->first, from)
+            : 0;
+    int lastDay = (index->days > 0) ? date_difference(index->first, to)
+            : -1;
+    if (firstDay < 0)
+        firstDay = 0;
+    if (lastDay >= index->days)
+        lastDay = index->days - 1;
+
+    if (firstDay > lastDay)
+        *start = *end = 0;
+    else {
+        *start = index->offsets[firstDay];
+        *end   = index->offsets[lastDay + 1];
+    }
+}
+
+/**
+ * Method to get the sales made between two dates.
+ * 
+ * @param  Pointer to index to be searched.
+ * @param  Date of first day of range.
+ * @param  Date of last day of range, inclusive.
+ * @return Iterator over sales of range, oldest first.
+ */
+SalesRange salesIndex_range(const SalesIndex *index, Date from, Date to) {
+    int start, end;
+    salesIndex_bounds(index, from, to, &start, &end);
+
+    SalesRange range = { index->sales->records, index->positions + start,
+            index->positions + end };
+    return range;
+}
+
+/**
+ * Method to count the sales made between two dates, in constant time.
+ * 
+ * @param  Pointer to index to be searched.
+ * @param  Date of first day of range.
+ * @param  Date of last day of range, inclusive.
+ * @return Integer number of sales in range.
+ */
+int salesIndex_count(const SalesIndex *index, Date from, Date to) {
+    int start, end;
+    salesIndex_bounds(index, from, to, &start, &end);
+
+    return end - start;
+}
+
+/**
+ * Method to total the units sold between two dates.
+ * 
+ * @param  Pointer to index to be searched.
+ * @param  Date of first day of range.
+ * @param  Date of last day of range, inclusive.
+ * @return Total quantity of all sales in range.
+ */
+long long salesIndex_units(const SalesIndex *index, Date from, Date to) {
+    SalesRange range = salesIndex_range(index, from, to);
+    long long units = 0;
+
+    for (SalesIterator i = salesRange_next(&range); i != NULL;
+            i = salesRange_next(&range))
+        units += i->quantity;
+
+    return units;
+}
+
+/**
+ * Method to total the revenue of sales made between two dates.
+ * 
+ * @param  Pointer to index to be searched.
+ * @param  Date of first day of range.
+ * @param  Date of last day of range, inclusive.
+ * @return Total revenue of all sales in range in pennies.
+ */
+Money salesIndex_revenue(const SalesIndex *index, Date from, Date to) {
+    SalesRange range = salesIndex_range(index, from, to);
+    Money revenue = 0;
+
+    for (SalesIterator i = salesRange_next(&range); i != NULL;
+            i = salesRange_next(&range))
+        revenue += sales_getTotal(i);
+
+    return revenue;
+}
+
+/**
+ * Method to free a index from memory, leaving its sales list.
+ * 
+ * @param Pointer to index to which will be freed from memory.
+ */
+void salesIndex_free(SalesIndex *index) {
+    free(index->offsets);
+    free(index->positions);
+    free(index);
+}
@@ -0,0 +1,127 @@
+/* 
+ * File:   SalesIndex.h
+ * Author: Paulo Jorge
+ */
+
+#ifndef SALESINDEX_H
+#define SALESINDEX_H
+
+#include "Date.h"
+#include "Sales.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Index over a sales list by date. Positions of sales records are kept
+ * grouped by day, oldest first and in sales list order within a day, with
+ * a table holding where each day starts. Any date range is found with two
+ * lookups in the table, then only its own sales are visited.
+ */
+typedef struct SalesIndexStruct {
+    const Sales *sales;
+    // First day covered and number of days covered
+    Date first;
+    int days;
+    // Start of each day within positions, plus end of last day
+    int *offsets;
+    // Positions of sales records grouped by day
+    int *positions;
+}
+SalesIndex;
+
+/**
+ * Iterator over the sales of a date range.
+ */
+typedef struct SalesRangeStruct {
+    const SalesRecord *records;
+    const int *position, *end;
+}
+SalesRange;
+
+/**
+ * Method to allocate memory for a new index over a sales list, built in
+ * time proportional to the number of sales and days covered. The index
+ * must be rebuilt with salesIndex_rebuild() once sales have changed. Or
+ * generates error message if memory allocation fails and terminates
+ * program.
+ * 
+ * @param  Pointer to sales list to be indexed.
+ * @return Pointer to newly created index.
+ */
+SalesIndex *salesIndex_new(const Sales *sales);
+
+/**
+ * Method to rebuild a index so it covers the current sales of its sales
+ * list. Or generates error message if memory allocation fails and
+ * terminates program.
+ * 
+ * @param Pointer to index to be rebuilt.
+ */
+void salesIndex_rebuild(SalesIndex *index);
+
+/**
+ * Method to get the sales made between two dates.
+ * 
+ * @param  Pointer to index to be searched.
+ * @param  Date of first day of range.
+ * @param  Date of last day of range, inclusive.
+ * @return Iterator over sales of range, oldest first.
+ */
+SalesRange salesIndex_range(const SalesIndex *index, Date from, Date to);
+
+/**
+ * Method to get the next sale of a date range.
+ * 
+ * @param  Pointer to iterator over range.
+ * @return Next sales record, or null once all sales have been visited.
+ */
+static inline SalesIterator salesRange_next(SalesRange *range) {
+    return (range->position < range->end)
+            ? (SalesIterator)&range->records[*range->position++] : NULL;
+}
+
+/**
+ * Method to count the sales made between two dates, in constant time.
+ * 
+ * @param  Pointer to index to be searched.
+ * @param  Date of first day of range.
+ * @param  Date of last day of range, inclusive.
+ * @return Integer number of sales in range.
+ */
+int salesIndex_count(const SalesIndex *index, Date from, Date to);
+
+/**
+ * Method to total the units sold between two dates.
+ * 
+ * @param  Pointer to index to be searched.
+ * @param  Date of first day of range.
+ * @param  Date of last day of range, inclusive.
+ * @return Total quantity of all sales in range.
+ */
+long long salesIndex_units(const SalesIndex *index, Date from, Date to);
+
+/**
+ * Method to total the revenue of sales made between two dates.
+ * 
+ * @param  Pointer to index to be searched.
+ * @param  Date of first day of range.
+ * @param  Date of last day of range, inclusive.
+ * @return Total revenue of all sales in range in pennies.
+ */
+Money salesIndex_revenue(const SalesIndex *index, Date from, Date to);
+
+/**
+ * Method to free a index from memory, leaving its sales list.
+ * 
+ * @param Pointer to index to which will be freed from memory.
+ */
+void salesIndex_free(SalesIndex *index);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SALESINDEX_H */
+
@@ -0,0 +1,279 @@
+/* 
+ * File:   SalesRollup.c
+ * Author: Paulo Jorge
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SalesRollup.h"
+#include "StockItem.h"
+#include "ComponentType.h"
+
+/**
+ * Method to allocate a array of totals. Or generates error message if
+ * memory allocation fails and terminates program.
+ * 
+ * @param  Integer number of totals.
+ * @param  Size of each total in bytes.
+ * @return Pointer to newly allocated zeroed totals.
+ */
+static void *salesRollup_totals(size_t count, size_t size) {
+    void *totals = calloc(count ? count : 1, size);
+    // Null check memory allocation
+    if (!totals) {
+        fprintf(stderr, "Error: Unable to allocate memory in "
+                "salesRollup_totals().\n");
+        exit(EXIT_FAILURE);
+    }
+    return totals;
+}
+
+/**
+ * Method to add a sale to the daily totals of its type and of all types.
+ * 
+ * @param Pointer to rollup to be added to.
+ * @param Pointer to sales record within days and types covered.
+ */
+static inline void salesRollup_add(SalesRollup *rollup,
+        const SalesRecord *record) {
+    int day = date_difference(rollup->first, record->date);
+    size_t row = (size_t)(stockItem_getTypeCode(record->item) + 1)
+            * rollup->days;
+    Money revenue = sales_getTotal(record);
+
+    rollup->dayRevenue[day]       += revenue;
+    rollup->dayUnits[day]         += record->quantity;
+    rollup->dayRevenue[row + day] += revenue;
+    rollup->dayUnits[row + day]   += record->quantity;
+
+    if (day < rollup->dirtyFrom)
+        rollup->dirtyFrom = day;
+}
+
+/**
+ * Method to rebuild a rollup from every sale in its sales list, covering
+ * exactly the days and types of its sales. Or generates error message if
+ * memory allocation fails and terminates program.
+ * 
+ * @param Pointer to rollup to be rebuilt.
+ */
+static void salesRollup_rebuild(SalesRollup *rollup) {
+    const SalesRecord *records = rollup->sales->records;
+    int count = rollup->sales->count;
+
+    // Find range of days covered
+    Date first = DATE_NONE, last = DATE_NONE;
+    for (int i = 0; i < count; i++) {
+        if ((first == DATE_NONE) || (records[i].date < first))
+            first = records[i].date;
+        if ((last == DATE_NONE) || (records[i].date > last))
+            last = records[i].date;
+    }
+    rollup->first = first;
+    rollup->days  = count ? date_difference(first, last) + 1 : 0;
+    rollup->rows  = componentType_count() + 1;
+
+    size_t cells = (size_t)rollup->rows * rollup->days;
+    free(rollup->dayRevenue);
+    free(rollup->dayUnits);
+    free(rollup->revenue);
+    free(rollup->units);
+    rollup->dayRevenue = (Money*)salesRollup_totals(cells, sizeof(Money));
+    rollup->dayUnits   = (long long*)salesRollup_totals(cells, 
+            sizeof(long long));
+    rollup->revenue    = (Money*)salesRollup_totals(cells + rollup->rows, 
+            sizeof(Money));
+    rollup->units      = (long long*)salesRollup_totals(cells + rollup->rows,
+            sizeof(long long));
+
+    // Add every sale, running totals are all computed on next query
+    rollup->dirtyFrom = 0;
+    for (int i = 0; i < count; i++)
+        salesRollup_add(rollup, &records[i]);
+    rollup->processed     = count;
+    rollup->modifications = rollup->sales->modifications;
+}
+
+/**
+ * Method to allocate memory for a new rollup of a sales list. Or generates
+ * error message if memory allocation fails and terminates program.
+ * 
+ * @param  Pointer to sales list to be rolled up.
+ * @return Pointer to newly created rollup.
+ */
+SalesRollup *salesRollup_new(const Sales *sales) {
+    // Allocate rollup to memory
+    SalesRollup *rollup = (SalesRollup*)malloc(sizeof(SalesRollup));
+    // Null check memory allocation
+    if (!rollup) {
+        fprintf(stderr, "Error: Unable to allocate memory in "
+                "salesRollup_new().\n");
+        exit(EXIT_FAILURE);
+    }
+
+    rollup->sales      = sales;
+    rollup->dayRevenue = NULL;
+    rollup->dayUnits   = NULL;
+    rollup->revenue    = NULL;
+    rollup->units      = NULL;
+    salesRollup_rebuild(rollup);
+
+    return rollup;
+}
+
+/**
+ * Method to bring a rollup up to date with its sales list. Sales appended
+ * since it was last updated are added to it, and it is rebuilt if sales
+ * have been inserted or removed or fall outside the days or types it 
+ * covers. Called by every query, so only needed to control when the work
+ * is done. Or generates error message if memory allocation fails and
+ * terminates program.
+ * 
+ * @param Pointer to rollup to be updated.
+ */
+void salesRollup_update(SalesRollup *rollup) {
+    const SalesRecord *records = rollup->sales->records;
+    int count = rollup->sales->count;
+
+    // Rebuild if sales have been inserted or removed, or new sales are not
+    // covered
+    int rebuild = (rollup->modifications != rollup->sales->modifications)
+            || (count < rollup->processed);
+    for (int i = rollup->processed; (i < count) && !rebuild; i++) {
+        int day = date_difference(rollup->first, records[i].date);
+        rebuild = (day < 0) || (day >= rollup->days)
+                || (stockItem_getTypeCode(records[i].item) + 1
+                    >= rollup->rows);
+    }
+
+    if (rebuild)
+        salesRollup_rebuild(rollup);
+    else {
+        // Add new sales to daily totals
+        for (int i = rollup->processed; i < count; i++)
+            salesRollup_add(rollup, &records[i]);
+        rollup->processed = count;
+    }
+
+    // Recompute running totals from oldest day changed
+    if (rollup->dirtyFrom < rollup->days) {
+        for (int row = 0; row < rollup->rows; row++) {
+            const Money *dayRevenue = rollup->dayRevenue
+                    + (size_t)row * rollup->days;
+            const long long *dayUnits = rollup->dayUnits
+                    + (size_t)row * rollup->days;
+            Money *revenue = rollup->revenue
+                    + (size_t)row * (rollup->days + 1);
+            long long *units = rollup->units
+                    + (size_t)row * (rollup->days + 1);
+
+            for (int day = rollup->dirtyFrom; day < rollup->days; day++) {
+                revenue[day + 1] = revenue[day] + dayRevenue[day];
+                units[day + 1]   = units[day] + dayUnits[day];
+            }
+        }
+        rollup->dirtyFrom = rollup->days;
+    }
+}
+
+/**
+ * Method to get the totals of sales made between two dates.
+ * 
+ * @param  Pointer to rollup to be queried.
+ * @param  Integer component type code, or COMPONENT_TYPE_NONE for all
+ *         types.
+ * @param  Date of first day of range.
+ * @param  Date of last day of range, inclusive.
+ * @return Totals of sales in range.
+ */
+SalesRollupTotal salesRollup_range(SalesRollup *rollup, int type, Date from,
+        Date to) {
+    SalesRollupTotal total = { 0, 0 };
+    salesRollup_update(rollup);
+
+    // Types without sales have no row
+    int row = type + 1;
+    if ((row < 0) || (row >= rollup->rows) || (rollup->days == 0))
+        return total;
+
+    // Clamp range to days covered
+    int firstDay = date_difference(rollup->first, from);
+    int lastDay = date_difference(rollup->first, to);
+    if (firstDay < 0)
+        firstDay = 0;
+    if (lastDay >= rollup->days)
+        lastDay = rollup->days - 1;
+    if (firstDay > lastDay)
+        return total;
+
+    // Difference of running totals after last day and before first day
+    const Money *revenue = rollup->revenue
+            + (size_t)row * (rollup->days + 1);
+    const long long *units = rollup->units
+            + (size_t)row * (rollup->days + 1);
+    total.revenue = revenue[lastDay + 1] - revenue[firstDay];
+    total.units   = units[lastDay + 1] - units[firstDay];
+
+    return total;
+}
+
+/**
+ * Method to get the totals of sales made in a month.
+ * 
+ * @param  Pointer to rollup to be queried.
+ * @param  Integer component type code, or COMPONENT_TYPE_NONE for all
+ *         types.
+ * @param  Month integer, such as 10.
+ * @param  Full year integer value, such as 2017.
+ * @return Totals of sales in month.
+ */
+SalesRollupTotal salesRollup_month(SalesRollup *rollup, int type, int month,
+        int year) {
+    Date from = date_fromDMY(1, month, year);
+
+    // Months outside supported dates have no sales
+    if (from == DATE_NONE) {
+        SalesRollupTotal total = { 0, 0 };
+        return total;
+    }
+    
+    // Month ends the day before the next month starts
+    Date to = (month < 12) ? date_fromDMY(1, month + 1, year) - 1
+            : date_fromDMY(31, 12, year);
+    return salesRollup_range(rollup, type, from, to);
+}
+
+/**
+ * Method to get the totals of sales made in a year.
+ * 
+ * @param  Pointer to rollup to be queried.
+ * @param  Integer component type code, or COMPONENT_TYPE_NONE for all
+ *         types.
+ * @param  Full year integer value, such as 2017.
+ * @return Totals of sales in year.
+ */
+SalesRollupTotal salesRollup_year(SalesRollup *rollup, int type, int year) {
+    Date from = date_fromDMY(1, 1, year);
+    Date to = date_fromDMY(31, 12, year);
+
+    // Years outside supported dates have no sales
+    if ((from == DATE_NONE) || (to == DATE_NONE)) {
+        SalesRollupTotal total = { 0, 0 };
+        return total;
+    }
+    return salesRollup_range(rollup, type, from, to);
+}
+
+/**
+ * Method to free a rollup from memory, leaving its sales list.
+ * 
+ * @param Pointer to rollup to which will be freed from memory.
+ */
+void salesRollup_free(SalesRollup *rollup) {
+    free(rollup->dayRevenue);
+    free(rollup->dayUnits);
+    free(rollup->revenue);
+    free(rollup->units);
+    free(rollup);
+}
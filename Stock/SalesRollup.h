@@ -0,0 +1,128 @@
+/* 
+ * File:   SalesRollup.h
+ * Author: Paulo Jorge
+ */
+
+#ifndef SALESROLLUP_H
+#define SALESROLLUP_H
+
+#include "Date.h"
+#include "Sales.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Structure holding the totals of a set of sales.
+ */
+typedef struct SalesRollupTotalStruct {
+    // Total revenue in pennies and total number of units sold
+    Money revenue;
+    long long units;
+}
+SalesRollupTotal;
+
+/**
+ * Rollup of the revenue and units sold each day for every component type,
+ * and for all types together, with running totals from the first day so
+ * the totals of any date range are the difference of two running totals.
+ * 
+ * Sales appended to the sales list since the rollup was last used are
+ * added to the daily totals when it is next used, and running totals are
+ * only recomputed from the oldest day changed. Any other change to the
+ * sales list, such as sales_insert() or sales_removeHead(), is detected by
+ * its modification count and the rollup is rebuilt.
+ */
+typedef struct SalesRollupStruct {
+    const Sales *sales;
+    // Number of sales records included, and modification count of sales
+    // list when they were
+    int processed;
+    unsigned long modifications;
+    // First day covered, number of days covered and number of rows, row 0
+    // being all types and row type + 1 being each component type
+    Date first;
+    int days, rows;
+    // Totals of each day by row, rows of days entries
+    Money *dayRevenue;
+    long long *dayUnits;
+    // Running totals before each day by row, rows of days + 1 entries
+    Money *revenue;
+    long long *units;
+    // First day whose running totals are out of date, or days if none are
+    int dirtyFrom;
+}
+SalesRollup;
+
+/**
+ * Method to allocate memory for a new rollup of a sales list. Or generates
+ * error message if memory allocation fails and terminates program.
+ * 
+ * @param  Pointer to sales list to be rolled up.
+ * @return Pointer to newly created rollup.
+ */
+SalesRollup *salesRollup_new(const Sales *sales);
+
+/**
+ * Method to bring a rollup up to date with its sales list. Sales appended
+ * since it was last updated are added to it, and it is rebuilt if sales
+ * have been inserted or removed or fall outside the days or types it 
+ * covers. Called by every query, so only needed to control when the work
+ * is done. Or generates error message if memory allocation fails and
+ * terminates program.
+ * 
+ * @param Pointer to rollup to be updated.
+ */
+void salesRollup_update(SalesRollup *rollup);
+
+/**
+ * Method to get the totals of sales made between two dates.
+ * 
+ * @param  Pointer to rollup to be queried.
+ * @param  Integer component type code, or COMPONENT_TYPE_NONE for all
+ *         types.
+ * @param  Date of first day of range.
+ * @param  Date of last day of range, inclusive.
+ * @return Totals of sales in range.
+ */
+SalesRollupTotal salesRollup_range(SalesRollup *rollup, int type, Date from,
+        Date to);
+
+/**
+ * Method to get the totals of sales made in a month.
+ * 
+ * @param  Pointer to rollup to be queried.
+ * @param  Integer component type code, or COMPONENT_TYPE_NONE for all
+ *         types.
+ * @param  Month integer, such as 10.
+ * @param  Full year integer value, such as 2017.
+ * @return Totals of sales in month.
+ */
+SalesRollupTotal salesRollup_month(SalesRollup *rollup, int type, int month,
+        int year);
+
+/**
+ * Method to get the totals of sales made in a year.
+ * 
+ * @param  Pointer to rollup to be queried.
+ * @param  Integer component type code, or COMPONENT_TYPE_NONE for all
+ *         types.
+ * @param  Full year integer value, such as 2017.
+ * @return Totals of sales in year.
+ */
+SalesRollupTotal salesRollup_year(SalesRollup *rollup, int type, int year);
+
+/**
+ * Method to free a rollup from memory, leaving its sales list.
+ * 
+ * @param Pointer to rollup to which will be freed from memory.
+ */
+void salesRollup_free(SalesRollup *rollup);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SALESROLLUP_H */
+
@@ -0,0 +1,184 @@
+/* 
+ * File:   ShardedInventory.c
+ * Author: Paulo Jorge
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "ShardedInventory.h"
+
+/**
+ * Method to get the shard a stock item ID belongs to. IDs are hashed with
+ * FNV-1a and the shard is taken from the high bits, as each shard's own ID
+ * index uses the low bits of the same hash.
+ * 
+ * @param  Pointer to sharded inventory.
+ * @param  Char ID of stock item.
+ * @return Pointer to shard of ID.
+ */
+static InventoryShard *shardedInventory_shard(ShardedInventory *sharded,
+        const char *ID) {
+    unsigned int hash = 2166136261u;
+    for (const char *c = ID; *c != '\0'; c++)
+        hash = (hash ^ (unsigned char)*c) * 16777619u;
+
+    return &sharded->shards[(hash >> 16) & (sharded->shardCount - 1)];
+}
+
+/**
+ * Method to allocate memory for a new empty sharded inventory. Or
+ * generates error message if memory allocation fails and terminates
+ * program.
+ * 
+ * @param  Integer number of shards, rounded up to a power of two, or 0 for
+ *         SHARDED_INVENTORY_DEFAULT_SHARDS.
+ * @return Pointer to newly created sharded inventory.
+ */
+ShardedInventory *shardedInventory_new(int shards) {
+    // Round number of shards up to a power of two, at most 2^16 as shards
+    // are chosen from 16 bits of the hash
+    int count = 1;
+    if (shards <= 0)
+        shards = SHARDED_INVENTORY_DEFAULT_SHARDS;
+    while ((count < shards) && (count < 65536))
+        count *= 2;
+
+    // Allocate sharded inventory and shards to memory
+    ShardedInventory *sharded =
+            (ShardedInventory*)malloc(sizeof(ShardedInventory));
+    InventoryShard *array = (InventoryShard*)aligned_alloc(
+            _Alignof(InventoryShard), sizeof(InventoryShard) * count);
+    // Null check memory allocation
+    if (!sharded || !array) {
+        fprintf(stderr, "Error: Unable to allocate memory in "
+                "shardedInventory_new().\n");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int i = 0; i < count; i++) {
+        pthread_rwlock_init(&array[i].lock, NULL);
+        array[i].inventory = inventory_new();
+    }
+    sharded->shards     = array;
+    sharded->shardCount = count;
+
+    return sharded;
+}
+
+/**
+ * Method to add a stock item to the shard of its ID. Stock items with an
+ * ID already in the inventory are rejected.
+ * 
+ * @param  Pointer to sharded inventory to be added to.
+ * @param  Pointer to stock item to be added.
+ * @return 1 if stock item was added or 0 if its ID is a duplicate.
+ */
+int shardedInventory_add(ShardedInventory *sharded, StockItem *item) {
+    InventoryShard *shard = shardedInventory_shard(sharded,
+            stockItem_getID(item));
+
+    pthread_rwlock_wrlock(&shard->lock);
+    int added = inventory_add(shard->inventory, item);
+    pthread_rwlock_unlock(&shard->lock);
+
+    return added;
+}
+
+/**
+ * Method to find a stock item by ID.
+ * 
+ * @param  Pointer to sharded inventory to be searched.
+ * @param  Char ID of stock item to find.
+ * @return Stock item with the ID, or null if there is none.
+ */
+StockItem *shardedInventory_find(ShardedInventory *sharded, const char *ID) {
+    InventoryShard *shard = shardedInventory_shard(sharded, ID);
+
+    pthread_rwlock_rdlock(&shard->lock);
+    StockItem *item = inventory_find(shard->inventory, ID);
+    pthread_rwlock_unlock(&shard->lock);
+
+    return item;
+}
+
+/**
+ * Method to sell a quantity of the stock item with a ID, if there is
+ * enough in stock.
+ * 
+ * @param  Pointer to sharded inventory containing stock item.
+ * @param  Char ID of stock item to sell.
+ * @param  Integer sale quantity to sell.
+ * @return 1 if transaction was successful or 0 if stock item was not found
+ *         or there is not enough in stock.
+ */
+int shardedInventory_sell(ShardedInventory *sharded, const char *ID,
+        int quantity) {
+    InventoryShard *shard = shardedInventory_shard(sharded, ID);
+
+    // Quantity is changed atomically, so a read lock is enough
+    pthread_rwlock_rdlock(&shard->lock);
+    StockItem *item = inventory_find(shard->inventory, ID);
+    int sold = item && stockItem_Sell(item, quantity);
+    pthread_rwlock_unlock(&shard->lock);
+
+    return sold;
+}
+
+/**
+ * Method to restock a quantity of the stock item with a ID.
+ * 
+ * @param  Pointer to sharded inventory containing stock item.
+ * @param  Char ID of stock item to restock.
+ * @param  Integer quantity to add to stock.
+ * @return 1 if stock item was restocked or 0 if it was not found.
+ */
+int shardedInventory_restock(ShardedInventory *sharded, const char *ID,
+        int quantity) {
+    InventoryShard *shard = shardedInventory_shard(sharded, ID);
+
+    // Quantity is changed atomically, so a read lock is enough
+    pthread_rwlock_rdlock(&shard->lock);
+    StockItem *item = inventory_find(shard->inventory, ID);
+    if (item)
+        stockItem_Restock(item, quantity);
+    pthread_rwlock_unlock(&shard->lock);
+
+    return item != NULL;
+}
+
+/**
+ * Method to count the stock items in a sharded inventory. Shards are
+ * counted one at a time, so stock items added meanwhile may be missed.
+ * 
+ * @param  Pointer to sharded inventory to be counted.
+ * @return Integer number of stock items.
+ */
+int shardedInventory_count(ShardedInventory *sharded) {
+    int count = 0;
+
+    for (int i = 0; i < sharded->shardCount; i++) {
+        pthread_rwlock_rdlock(&sharded->shards[i].lock);
+        count += inventory_count(sharded->shards[i].inventory);
+        pthread_rwlock_unlock(&sharded->shards[i].lock);
+    }
+
+    return count;
+}
+
+/**
+ * Method to free a sharded inventory from memory, leaving its stock items.
+ * 
+ * @param Pointer to sharded inventory to be freed from memory.
+ */
+void shardedInventory_free(ShardedInventory *sharded) {
+    for (int i = 0; i < sharded->shardCount; i++) {
+        inventory_free(sharded->shards[i].inventory);
+        pthread_rwlock_destroy(&sharded->shards[i].lock);
+    }
+
+    free(sharded->shards);
+    free(sharded);
+}
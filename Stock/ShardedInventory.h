@@ -0,0 +1,124 @@
+/* 
+ * File:   ShardedInventory.h
+ * Author: Paulo Jorge
+ */
+
+#ifndef SHARDEDINVENTORY_H
+#define SHARDEDINVENTORY_H
+
+#include <pthread.h>
+
+#include "StockItem.h"
+#include "Inventory.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Default number of shards, used when 0 shards are requested.
+ */
+#define SHARDED_INVENTORY_DEFAULT_SHARDS 64
+
+/**
+ * Structure defining one shard, a inventory guarded by its own lock.
+ * Shards are aligned to separate cache lines so threads using different
+ * shards do not contend on the same line.
+ */
+typedef struct InventoryShardStruct {
+    _Alignas(64) pthread_rwlock_t lock;
+    Inventory *inventory;
+}
+InventoryShard;
+
+/**
+ * Inventory split into shards by a hash of stock item ID, so threads
+ * finding, adding, selling and restocking stock items only contend when
+ * they use the same shard.
+ * 
+ * Finds, sales and restocks take a shard's lock for reading, as quantities
+ * are changed atomically by stockItem_Sell() and stockItem_Restock(), so
+ * any number of them run at once. Adds take it for writing.
+ */
+typedef struct ShardedInventoryStruct {
+    InventoryShard *shards;
+    // Number of shards, always a power of two
+    int shardCount;
+}
+ShardedInventory;
+
+/**
+ * Method to allocate memory for a new empty sharded inventory. Or
+ * generates error message if memory allocation fails and terminates
+ * program.
+ * 
+ * @param  Integer number of shards, rounded up to a power of two, or 0 for
+ *         SHARDED_INVENTORY_DEFAULT_SHARDS.
+ * @return Pointer to newly created sharded inventory.
+ */
+ShardedInventory *shardedInventory_new(int shards);
+
+/**
+ * Method to add a stock item to the shard of its ID. Stock items with an
+ * ID already in the inventory are rejected.
+ * 
+ * @param  Pointer to sharded inventory to be added to.
+ * @param  Pointer to stock item to be added.
+ * @return 1 if stock item was added or 0 if its ID is a duplicate.
+ */
+int shardedInventory_add(ShardedInventory *sharded, StockItem *item);
+
+/**
+ * Method to find a stock item by ID.
+ * 
+ * @param  Pointer to sharded inventory to be searched.
+ * @param  Char ID of stock item to find.
+ * @return Stock item with the ID, or null if there is none.
+ */
+StockItem *shardedInventory_find(ShardedInventory *sharded, const char *ID);
+
+/**
+ * Method to sell a quantity of the stock item with a ID, if there is
+ * enough in stock.
+ * 
+ * @param  Pointer to sharded inventory containing stock item.
+ * @param  Char ID of stock item to sell.
+ * @param  Integer sale quantity to sell.
+ * @return 1 if transaction was successful or 0 if stock item was not found
+ *         or there is not enough in stock.
+ */
+int shardedInventory_sell(ShardedInventory *sharded, const char *ID,
+        int quantity);
+
+/**
+ * Method to restock a quantity of the stock item with a ID.
+ * 
+ * @param  Pointer to sharded inventory containing stock item.
+ * @param  Char ID of stock item to restock.
+ * @param  Integer quantity to add to stock.
+ * @return 1 if stock item was restocked or 0 if it was not found.
+ */
+int shardedInventory_restock(ShardedInventory *sharded, const char *ID,
+        int quantity);
+
+/**
+ * Method to count the stock items in a sharded inventory. Shards are
+ * counted one at a time, so stock items added meanwhile may be missed.
+ * 
+ * @param  Pointer to sharded inventory to be counted.
+ * @return Integer number of stock items.
+ */
+int shardedInventory_count(ShardedInventory *sharded);
+
+/**
+ * Method to free a sharded inventory from memory, leaving its stock items.
+ * 
+ * @param Pointer to sharded inventory to be freed from memory.
+ */
+void shardedInventory_free(ShardedInventory *sharded);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SHARDEDINVENTORY_H */
@@ -0,0 +1,432 @@
+/* 
+ * File:   Snapshot.c
+ * Author: Paulo Jorge
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <sys/stat.h>
+
+#include "Snapshot.h"
+#include "StockItem.h"
+#include "ComponentType.h"
+#include "Date.h"
+
+// Magic bytes identifying a snapshot file, and version of its layout
+#define SNAPSHOT_MAGIC "STOCKSNP"
+#define SNAPSHOT_VERSION 3
+
+// String offset used for a stock item without a description
+#define SNAPSHOT_NO_STRING UINT32_MAX
+
+// Maximum number of component types, matching the interned type codes
+#define SNAPSHOT_MAX_TYPES 256
+
+/**
+ * Structure defining the header at the start of a snapshot file. All
+ * fields are stored in native byte order, so snapshots are only read back
+ * on the machine that wrote them.
+ */
+typedef struct SnapshotHeaderStruct {
+    char magic[8];
+    uint32_t version, headerSize;
+    // Size and modification time of the source files
+    int64_t inventorySize, inventoryTime, salesSize, salesTime;
+    // Number of entries and offset of each section from start of file
+    uint32_t itemCount, saleCount, stringsSize, reserved;
+    uint64_t itemsOffset, salesOffset, stringsOffset;
+}
+SnapshotHeader;
+
+/**
+ * Structure defining a stock item within a snapshot, strings are stored
+ * as offsets into the string table.
+ */
+typedef struct SnapshotItemStruct {
+    int64_t price;
+    int32_t quantity;
+    uint32_t type, ID, desc;
+}
+SnapshotItem;
+
+/**
+ * Structure defining a sale within a snapshot. Stock items are referred to
+ * by their position in the items section and dates are stored as day
+ * ordinals.
+ */
+typedef struct SnapshotSaleStruct {
+    int32_t item, date, quantity;
+}
+SnapshotSale;
+
+/**
+ * Structure defining a string table being built for writing.
+ */
+typedef struct SnapshotStringsStruct {
+    char *data;
+    uint32_t size, capacity;
+}
+SnapshotStrings;
+
+/**
+ * Method to get the size and modification time of a file.
+ * 
+ * @param  File name of file to be checked.
+ * @param  Pointer to where size in bytes will be stored.
+ * @param  Pointer to where modification time in nanoseconds will be stored.
+ * @return 1 if file exists or 0 if it could not be checked.
+ */
+static int snapshot_fileStatus(const char *fileName, int64_t *size,
+        int64_t *time) {
+    struct stat status;
+    if (stat(fileName, &status) != 0)
+        return 0;
+
+    *size = (int64_t)status.st_size;
+    *time = (int64_t)status.st_mtim.tv_sec * 1000000000
+            + status.st_mtim.tv_nsec;
+    return 1;
+}
+
+/**
+ * Method to append a string to a string table being built. Or generates
+ * error message if memory allocation fails and terminates program.
+ * 
+ * @param  Pointer to string table to be appended to.
+ * @param  String to be appended.
+ * @return Offset of string within the string table.
+ */
+static uint32_t snapshot_addString(SnapshotStrings *strings,
+        const char *string) {
+    uint32_t length = (uint32_t)strlen(string) + 1;
+
+    // Grow string table as needed
+    if (strings->size + length > strings->capacity) {
+        while (strings->size + length > strings->capacity)
+            strings->capacity = strings->capacity
+                    ? strings->capacity * 2 : 4096;
+        strings->data = (char*)realloc(strings->data, strings->capacity);
+        // Null check memory allocation
+        if (!strings->data) {
+            fprintf(stderr, "Error: Unable to allocate memory in "
+                    "snapshot_addString().\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    uint32_t offset = strings->size;
+    memcpy(strings->data + offset, string, length);
+    strings->size += length;
+
+    return offset;
+}
+
+/**
+ * Method to allocate a zeroed array for building a snapshot. Or generates
+ * error message if memory allocation fails and terminates program.
+ * 
+ * @param  Number of elements.
+ * @param  Size of each element.
+ * @return Pointer to newly allocated array.
+ */
+static void *snapshot_calloc(size_t count, size_t size) {
+    // Allocate at least one element so a empty inventory is not an error
+    void *data = calloc(count ? count : 1, size);
+    // Null check memory allocation
+    if (!data) {
+        fprintf(stderr, "Error: Unable to allocate memory in "
+                "snapshot_calloc().\n");
+        exit(EXIT_FAILURE);
+    }
+    return data;
+}
+
+/**
+ * Method to write a binary snapshot of a inventory and the sales applied
+ * to it. The snapshot holds each stock item with its quantity after sales,
+ * a table of all strings and a fixed size record for each sale, along
+ * with the size and modification time of the source files so it can be
+ * recognised as stale. The snapshot is written to a temporary file and
+ * renamed into place, so a failed write never leaves a partial snapshot.
+ * 
+ * @param  File name of snapshot to be written.
+ * @param  Pointer to inventory to be written.
+ * @param  Pointer to sales list applied to inventory.
+ * @param  File name of inventory file the inventory was read from.
+ * @param  File name of sales file the sales list was read from.
+ * @return 1 if snapshot was written or 0 if it could not be written.
+ */
+int snapshot_write(const char *fileName, const Inventory* inventory,
+        const Sales* sales, const char *inventoryFile,
+        const char *salesFile) {
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version    = SNAPSHOT_VERSION;
+    header.headerSize = sizeof(header);
+
+    // Record source files so stale snapshots can be detected
+    if (!snapshot_fileStatus(inventoryFile, &header.inventorySize,
+                &header.inventoryTime)
+            || !snapshot_fileStatus(salesFile, &header.salesSize,
+                &header.salesTime))
+        return 0;
+
+    // Build items in inventory order, mapping item indexes to positions
+    int itemCount = inventory_count(inventory);
+    int indexCount = inventory_itemCount(inventory);
+    SnapshotItem *items = (SnapshotItem*)snapshot_calloc(itemCount,
+            sizeof(SnapshotItem));
+    int32_t *positions = (int32_t*)snapshot_calloc(indexCount,
+            sizeof(int32_t));
+    SnapshotStrings strings = { NULL, 0, 0 };
+    uint32_t typeNames[SNAPSHOT_MAX_TYPES];
+    int position = 0;
+
+    // Each type name is stored once
+    for (int type = 0; type < SNAPSHOT_MAX_TYPES; type++)
+        typeNames[type] = SNAPSHOT_NO_STRING;
+
+    for (InventoryIterator i = inventory_first(inventory); i != NULL;
+            i = inventory_iteratorNext(i), position++) {
+        StockItem *item = i->item;
+        int type = stockItem_getTypeCode(item);
+
+        if (typeNames[type] == SNAPSHOT_NO_STRING)
+            typeNames[type] = snapshot_addString(&strings,
+                    stockItem_getType(item));
+
+        items[position].quantity = stockItem_getQuantity(item);
+        items[position].price    = stockItem_getPennies(item);
+        items[position].type     = typeNames[type];
+        items[position].ID       = snapshot_addString(&strings,
+                stockItem_getID(item));
+        items[position].desc     = item->desc
+                ? snapshot_addString(&strings, item->desc)
+                : SNAPSHOT_NO_STRING;
+        positions[stockItem_getIndex(item)] = position;
+    }
+
+    // Build sales, a sale of a removed stock item can not be restored
+    int saleCount = sales_count(sales);
+    SnapshotSale *records = (SnapshotSale*)snapshot_calloc(saleCount,
+            sizeof(SnapshotSale));
+    int sale = 0, restorable = 1;
+
+    for (SalesIterator i = sales_first(sales); i != NULL;
+            i = sales_iteratorNext(i), sale++) {
+        int index = stockItem_getIndex(i->item);
+        if (index < 0) {
+            restorable = 0;
+            break;
+        }
+
+        records[sale].item     = positions[index];
+        records[sale].date     = i->date;
+        records[sale].quantity = i->quantity;
+    }
+
+    // Lay out sections one after another
+    header.itemCount     = (uint32_t)itemCount;
+    header.saleCount     = (uint32_t)saleCount;
+    header.stringsSize   = strings.size;
+    header.itemsOffset   = sizeof(header);
+    header.salesOffset   = header.itemsOffset
+            + sizeof(SnapshotItem) * (uint64_t)itemCount;
+    header.stringsOffset = header.salesOffset
+            + sizeof(SnapshotSale) * (uint64_t)saleCount;
+
+    // Write to a temporary file which replaces the snapshot once complete
+    int written = 0;
+    size_t length = strlen(fileName);
+    char *temporary = (char*)snapshot_calloc(length + 5, 1);
+    memcpy(temporary, fileName, length);
+    memcpy(temporary + length, ".tmp", 5);
+
+    FILE *file = restorable ? fopen(temporary, "wb") : NULL;
+    if (file) {
+        written = (fwrite(&header, sizeof(header), 1, file) == 1)
+                && (fwrite(items, sizeof(SnapshotItem), itemCount, file)
+                    == (size_t)itemCount)
+                && (fwrite(records, sizeof(SnapshotSale), saleCount, file)
+                    == (size_t)saleCount)
+                && (fwrite(strings.data, 1, strings.size, file)
+                    == strings.size);
+        written = (fclose(file) == 0) && written
+                && (rename(temporary, fileName) == 0);
+
+        // Remove partial snapshot if it could not be completed
+        if (!written)
+            remove(temporary);
+    }
+
+    free(temporary);
+    free(strings.data);
+    free(records);
+    free(positions);
+    free(items);
+
+    return written;
+}
+
+/**
+ * Method to check a mapped snapshot header matches this version of the
+ * program and the current source files, and that every section lies
+ * within the file.
+ * 
+ * @param  Pointer to mapped snapshot.
+ * @param  File name of inventory file the snapshot must match.
+ * @param  File name of sales file the snapshot must match.
+ * @return Pointer to header if it is valid or null if it is not.
+ */
+static const SnapshotHeader *snapshot_checkHeader(const MappedFile *file,
+        const char *inventoryFile, const char *salesFile) {
+    const SnapshotHeader *header = (const SnapshotHeader*)file->data;
+    int64_t inventorySize, inventoryTime, salesSize, salesTime;
+
+    // Check header is from this version
+    if ((file->size < sizeof(SnapshotHeader))
+            || (memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic))
+                != 0)
+            || (header->version != SNAPSHOT_VERSION)
+            || (header->headerSize != sizeof(SnapshotHeader)))
+        return NULL;
+
+    // Check source files have not changed since snapshot was written
+    if (!snapshot_fileStatus(inventoryFile, &inventorySize, &inventoryTime)
+            || !snapshot_fileStatus(salesFile, &salesSize, &salesTime)
+            || (inventorySize != header->inventorySize)
+            || (inventoryTime != header->inventoryTime)
+            || (salesSize != header->salesSize)
+            || (salesTime != header->salesTime))
+        return NULL;
+
+    // Check sections are where they are expected and fill the file
+    uint64_t salesOffset = header->itemsOffset
+            + sizeof(SnapshotItem) * (uint64_t)header->itemCount;
+    uint64_t stringsOffset = salesOffset
+            + sizeof(SnapshotSale) * (uint64_t)header->saleCount;
+    if ((header->itemsOffset != sizeof(SnapshotHeader))
+            || (header->salesOffset != salesOffset)
+            || (header->stringsOffset != stringsOffset)
+            || (stringsOffset + header->stringsSize != file->size))
+        return NULL;
+
+    // Check string table ends with a terminator so no string can overrun
+    if ((header->stringsSize > 0)
+            && (file->data[file->size - 1] != '\0'))
+        return NULL;
+
+    return header;
+}
+
+/**
+ * Method to load a inventory and sales list from a binary snapshot with a
+ * single mapping of the file. Strings are used in place, stock items are
+ * taken from the inventory's arena and no sales are replayed. The snapshot
+ * is rejected if it is missing, from a different version, corrupt or if
+ * either source file has changed since it was written, in which case the
+ * source files should be read instead.
+ * 
+ * @param  Pointer to snapshot to be opened.
+ * @param  File name of snapshot to be loaded.
+ * @param  Pointer to empty inventory where stock items will be added to.
+ * @param  Pointer to empty sales list where sales will be added to.
+ * @param  File name of inventory file the snapshot must match.
+ * @param  File name of sales file the snapshot must match.
+ * @return 1 if snapshot was loaded or 0 if it was rejected, leaving the
+ *         inventory and sales list empty.
+ */
+int snapshot_load(Snapshot *snapshot, const char *fileName,
+        Inventory* inventory, Sales* sales, const char *inventoryFile,
+        const char *salesFile) {
+    int64_t size, time;
+    snapshot->file.data = NULL;
+    snapshot->file.size = 0;
+
+    // Missing snapshot is not an error, it has just not been written yet
+    if (!snapshot_fileStatus(fileName, &size, &time))
+        return 0;
+
+    // Snapshot that can not be read is not an error either, the source 
+    // files are read instead
+    if (!mappedFile_tryOpen(&snapshot->file, fileName))
+        return 0;
+    const SnapshotHeader *header = snapshot_checkHeader(&snapshot->file,
+            inventoryFile, salesFile);
+    if (!header) {
+        snapshot_close(snapshot);
+        return 0;
+    }
+
+    const char *data = snapshot->file.data;
+    const SnapshotItem *items =
+            (const SnapshotItem*)(data + header->itemsOffset);
+    const SnapshotSale *records =
+            (const SnapshotSale*)(data + header->salesOffset);
+    const char *strings = data + header->stringsOffset;
+    uint32_t stringsSize = header->stringsSize;
+
+    // Check every reference and value before anything is added
+    for (uint32_t i = 0; i < header->itemCount; i++)
+        if ((items[i].type >= stringsSize) || (items[i].ID >= stringsSize)
+                || ((items[i].desc != SNAPSHOT_NO_STRING)
+                    && (items[i].desc >= stringsSize))
+                || (items[i].quantity < 0)) {
+            snapshot_close(snapshot);
+            return 0;
+        }
+    Date first = date_fromDMY(1, 1, 1000), last = date_fromDMY(31, 12, 9999);
+    for (uint32_t i = 0; i < header->saleCount; i++)
+        if ((records[i].item < 0)
+                || ((uint32_t)records[i].item >= header->itemCount)
+                || (records[i].date < first) || (records[i].date > last)
+                || (records[i].quantity < 0)) {
+            snapshot_close(snapshot);
+            return 0;
+        }
+
+    // Fix up stock items to point into the string table
+    StockItem **loaded = (StockItem**)snapshot_calloc(header->itemCount,
+            sizeof(StockItem*));
+    for (uint32_t i = 0; i < header->itemCount; i++) {
+        loaded[i] = stockItem_init((StockItem*)arena_alloc(
+                inventory_getArena(inventory), sizeof(StockItem)),
+                strings + items[i].type,
+                (char*)(strings + items[i].ID), items[i].quantity,
+                items[i].price, (items[i].desc != SNAPSHOT_NO_STRING)
+                    ? (char*)(strings + items[i].desc) : NULL);
+
+        // Duplicate IDs mean snapshot is corrupt
+        if (!inventory_add(inventory, loaded[i])) {
+            inventory_clear(inventory);
+            free(loaded);
+            snapshot_close(snapshot);
+            return 0;
+        }
+    }
+
+    // Restore sales, whose quantities are already taken from stock
+    sales_reserve(sales, (int)header->saleCount);
+    for (uint32_t i = 0; i < header->saleCount; i++)
+        sales_append(sales, loaded[records[i].item], records[i].date,
+                records[i].quantity);
+
+    free(loaded);
+
+    return 1;
+}
+
+/**
+ * Method to close a snapshot opened by snapshot_load(). Must only be
+ * called once the inventory loaded from it has been freed.
+ * 
+ * @param Pointer to snapshot to be closed.
+ */
+void snapshot_close(Snapshot *snapshot) {
+    mappedFile_close(&snapshot->file);
+}
@@ -0,0 +1,80 @@
+/* 
+ * File:   Snapshot.h
+ * Author: Paulo Jorge
+ */
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "Inventory.h"
+#include "Sales.h"
+#include "Loader.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Structure defining a loaded snapshot. Stock item IDs and descriptions
+ * point into the mapped file, so a snapshot must stay open until its
+ * inventory is no longer used.
+ */
+typedef struct SnapshotStruct {
+    MappedFile file;
+}
+Snapshot;
+
+/**
+ * Method to write a binary snapshot of a inventory and the sales applied
+ * to it. The snapshot holds each stock item with its quantity after sales,
+ * a table of all strings and a fixed size record for each sale, along
+ * with the size and modification time of the source files so it can be
+ * recognised as stale. The snapshot is written to a temporary file and
+ * renamed into place, so a failed write never leaves a partial snapshot.
+ * 
+ * @param  File name of snapshot to be written.
+ * @param  Pointer to inventory to be written.
+ * @param  Pointer to sales list applied to inventory.
+ * @param  File name of inventory file the inventory was read from.
+ * @param  File name of sales file the sales list was read from.
+ * @return 1 if snapshot was written or 0 if it could not be written.
+ */
+int snapshot_write(const char *fileName, const Inventory* inventory,
+        const Sales* sales, const char *inventoryFile,
+        const char *salesFile);
+
+/**
+ * Method to load a inventory and sales list from a binary snapshot with a
+ * single mapping of the file. Strings are used in place, stock items are
+ * taken from the inventory's arena and no sales are replayed. The snapshot
+ * is rejected if it is missing, from a different version, corrupt or if
+ * either source file has changed since it was written, in which case the
+ * source files should be read instead.
+ * 
+ * @param  Pointer to snapshot to be opened.
+ * @param  File name of snapshot to be loaded.
+ * @param  Pointer to empty inventory where stock items will be added to.
+ * @param  Pointer to empty sales list where sales will be added to.
+ * @param  File name of inventory file the snapshot must match.
+ * @param  File name of sales file the snapshot must match.
+ * @return 1 if snapshot was loaded or 0 if it was rejected, leaving the
+ *         inventory and sales list empty.
+ */
+int snapshot_load(Snapshot *snapshot, const char *fileName,
+        Inventory* inventory, Sales* sales, const char *inventoryFile,
+        const char *salesFile);
+
+/**
+ * Method to close a snapshot opened by snapshot_load(). Must only be
+ * called once the inventory loaded from it has been freed.
+ * 
+ * @param Pointer to snapshot to be closed.
+ */
+void snapshot_close(Snapshot *snapshot);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SNAPSHOT_H */
+
@@ -5,24 +5,63 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <unistd.h>
 
 #include "StockItem.h"
+#include "ComponentType.h"
+#include "Aggregate.h"
 #include "Date.h"
+#include "Report.h"
+
+/**
+ * Method to fill in a new stock item in memory provided by the caller, 
+ * such as a inventory's arena. The type name is interned, so the string 
+ * passed in is not kept, and the description is parsed into a typed 
+ * attribute.
+ * 
+ * @param  Pointer to memory for stock item.
+ * @param  Char type/name of item.
+ * @param  Char unique ID.
+ * @param  Integer quantity of item in stock.
+ * @param  Price of item in pennies.
+ * @param  Char item description.
+ * @return Pointer to stock item.
+ */
+StockItem* stockItem_init(StockItem *item, const char *type, char *ID, 
+        int quantity, Money price, char *desc) {
+    // Pass in stock item information
+    item->type     = componentType_intern(type);
+    item->ID       = ID;
+    atomic_init(&item->quantity, quantity);
+    item->price    = price;
+    item->desc     = desc;
+    
+    // Parse description once so queries can use its numeric value
+    item->attribute = attribute_parse(type, desc);
+    
+    // Not indexed or counted in any aggregates until added to a inventory
+    item->index         = -1;
+    item->aggregates    = NULL;
+    item->aggregateMask = 0;
+                
+    return item;
+}
 
 /**
  * Method to allocate memory for a new stock item containing information 
  * about itself. Or generates error message if memory allocation fails
- * and terminates program.
+ * and terminates program. The type name is interned, so the string passed 
+ * in is not kept, and the description is parsed into a typed attribute.
  * 
  * @param  Char type/name of item.
  * @param  Char unique ID.
  * @param  Integer quantity of item in stock.
- * @param  Integer price of item in pennies.
+ * @param  Price of item in pennies.
  * @param  Char item description.
  * @return Pointer to newly created stock item.
  */
-StockItem* stockItem_new(char *type, char *ID, int quantity, 
-        int price, char *desc) {
+StockItem* stockItem_new(const char *type, char *ID, int quantity, 
+        Money price, char *desc) {
     // Allocate item to memory
     StockItem *item = (StockItem*)malloc(sizeof(StockItem));
     // Null check memory allocation
@@ -32,14 +71,59 @@ StockItem* stockItem_new(char *type, char *ID, int quantity,
         exit(EXIT_FAILURE);
     }
     
-    // Pass in stock item information
-    item->type     = type;
-    item->ID       = ID;
-    item->quantity = quantity;
-    item->price    = price;
-    item->desc     = desc;
-                
-    return item;
+    return stockItem_init(item, type, ID, quantity, price, desc);
+}
+
+/**
+ * Method to allocate memory for a copy of a stock item with a different
+ * quantity. The copy shares the ID and description strings of the 
+ * original and is not in any inventory. Or generates error message if 
+ * memory allocation fails and terminates program.
+ * 
+ * @param  Pointer to stock item to be copied.
+ * @param  Integer quantity of copy in stock.
+ * @return Pointer to newly created copy.
+ */
+StockItem* stockItem_copy(const StockItem *item, int quantity) {
+    // Allocate copy to memory
+    StockItem *copy = (StockItem*)malloc(sizeof(StockItem));
+    // Null check memory allocation
+    if (!copy) {
+        fprintf(stderr, "Error: Unable to allocate memory in "
+                "stockItem_copy().\n");
+        exit(EXIT_FAILURE);
+    }
+    
+    return stockItem_initCopy(copy, item, quantity);
+}
+
+/**
+ * Method to fill in a copy of a stock item with a different quantity in 
+ * memory provided by the caller, such as a inventory's arena. The copy 
+ * shares the ID and description strings of the original and is not in any
+ * inventory.
+ * 
+ * @param  Pointer to memory for copy.
+ * @param  Pointer to stock item to be copied.
+ * @param  Integer quantity of copy in stock.
+ * @return Pointer to copy.
+ */
+StockItem* stockItem_initCopy(StockItem *copy, const StockItem *item, 
+        int quantity) {
+    // Copy stock item information, description is already parsed
+    copy->type      = item->type;
+    copy->ID        = item->ID;
+    atomic_init(&copy->quantity, quantity);
+    copy->price     = item->price;
+    copy->desc      = item->desc;
+    copy->attribute = item->attribute;
+    
+    // Not indexed or counted in any aggregates until added to a inventory
+    copy->index         = -1;
+    copy->aggregates    = NULL;
+    copy->aggregateMask = 0;
+    
+    return copy;
 }
 
 /**
@@ -48,7 +132,17 @@ StockItem* stockItem_new(char *type, char *ID, int quantity,
  * @param  Pointer to stock item containing type.
  * @return Item type/name char. 
  */
-char *stockItem_getType(const StockItem *item) {
+const char *stockItem_getType(const StockItem *item) {
+    return componentType_getName(item->type);
+}
+
+/**
+ * Get method to get the interned type code of a stock item.
+ * 
+ * @param  Pointer to stock item containing type.
+ * @return Integer type code, see ComponentType.h. 
+ */
+int stockItem_getTypeCode(const StockItem *item) {
     return item->type;
 }
 
@@ -69,24 +163,28 @@ char *stockItem_getID(const StockItem *item) {
  * @return Integer quantity of stock. 
  */
 int stockItem_getQuantity(const StockItem *item) {
-    return item->quantity;
+    return atomic_load_explicit(&item->quantity, memory_order_relaxed);
 }
 
 /**
- * Get method to get price of a stock item in pounds.
+ * Get method to get price of a stock item in pounds. Kept for 
+ * compatibility, prices should be read with stockItem_getPennies().
  * 
- * @param  Pointer to stock item containing price integer in pennies.
+ * @param  Pointer to stock item containing price.
  * @return Item price float in pounds. 
  */
 float stockItem_getPrice(const StockItem *item) {
-    int pennies = item->price;
-    // Get total pounds
-    float pounds = pennies / 100;
-    // Get total pennies
-    pennies = pennies % 100;
-    
-    // Return pounds + decimal value of pennies
-    return (pounds + ((float)pennies / 100));
+    return money_toPounds(item->price);
+}
+
+/**
+ * Get method to get price of a stock item in pennies.
+ * 
+ * @param  Pointer to stock item containing price.
+ * @return Item price in pennies. 
+ */
+Money stockItem_getPennies(const StockItem *item) {
+    return item->price;
 }
 
 /**
@@ -100,43 +198,141 @@ char *stockItem_getDesc(const StockItem *item) {
     return item->desc ? item->desc : "N/A";
 }
 
+/**
+ * Get method to get the index of a stock item within the inventory it has
+ * been added to. Indexes are given out in the order stock items are added
+ * and are not reused.
+ * 
+ * @param  Pointer to stock item containing index.
+ * @return Integer index, or -1 if stock item is not in a inventory. 
+ */
+int stockItem_getIndex(const StockItem *item) {
+    return item->index;
+}
+
+/**
+ * Get method to get the typed attribute parsed from the description of a
+ * stock item, such as its resistance or capacitance.
+ * 
+ * @param  Pointer to stock item containing attribute.
+ * @return Attribute of stock item, of kind ATTRIBUTE_NONE if it has none. 
+ */
+Attribute stockItem_getAttribute(const StockItem *item) {
+    return item->attribute;
+}
+
 /**
  * Sale method used to reduce quantity of a stock item by x amount 
  * if stock item has enough quantity within stock for transaction to be 
- * successful.
+ * successful. Any aggregates covering the stock item are updated.
+ * 
+ * Quantity is checked and reduced with a compare and swap, so sales of 
+ * the same stock item can be made from several threads at once without 
+ * selling more than is in stock.
  * 
  * @param  Pointer to stock item containing quantity.
  * @param  Integer sale quantity to sell.
  * @return 1 if transaction was successful or 0 if not. 
  */
 int stockItem_Sell(StockItem *item, const int saleQuantity) {
-    int currentQuantity = stockItem_getQuantity(item);
-    // If transaction would be successful reduce quantity and return 1 for true
-    if ((currentQuantity - saleQuantity) >= 0) {
-        item->quantity = (currentQuantity - saleQuantity);
-        return 1;
-    }
-    else 
-        return 0;
+    int currentQuantity = atomic_load_explicit(&item->quantity, 
+            memory_order_relaxed);
+    
+    // Retry until quantity is reduced, or there is not enough in stock. A 
+    // failed swap reloads current quantity made by another thread
+    do {
+        if ((currentQuantity - saleQuantity) < 0)
+            return 0;
+    } while (!atomic_compare_exchange_weak_explicit(&item->quantity, 
+            &currentQuantity, currentQuantity - saleQuantity, 
+            memory_order_acq_rel, memory_order_relaxed));
+    
+    aggregateSet_applyDelta(item, -saleQuantity);
+    return 1;
+}
+
+/**
+ * Sale method used to make a run of sales of a stock item in order, each 
+ * only if there is enough stock left after the sales before it. Stock is 
+ * reduced once for the whole run, as if the sales had been made one at a 
+ * time by stockItem_Sell(). Any aggregates covering the stock item are 
+ * updated.
+ * 
+ * @param  Pointer to stock item containing quantity.
+ * @param  Array of sale quantities to sell.
+ * @param  Integer number of sales.
+ * @param  Array to set to 1 for each sale made or 0 if not.
+ * @return Total quantity sold.
+ */
+int stockItem_SellEach(StockItem *item, const int *saleQuantities, 
+        int count, unsigned char *sold) {
+    int currentQuantity = atomic_load_explicit(&item->quantity, 
+            memory_order_relaxed);
+    int remaining;
+    
+    // Decide every sale against current quantity, deciding again if 
+    // another thread changed quantity before it could be swapped
+    do {
+        remaining = currentQuantity;
+        for (int i = 0; i < count; i++) {
+            sold[i] = (remaining - saleQuantities[i]) >= 0;
+            if (sold[i])
+                remaining -= saleQuantities[i];
+        }
+    } while ((remaining != currentQuantity) 
+            && !atomic_compare_exchange_weak_explicit(&item->quantity, 
+            &currentQuantity, remaining, memory_order_acq_rel, 
+            memory_order_relaxed));
+    
+    aggregateSet_applyDelta(item, remaining - currentQuantity);
+    return currentQuantity - remaining;
+}
+
+/**
+ * Restock method used to increase quantity of a stock item by x amount. 
+ * Any aggregates covering the stock item are updated. Safe to call while 
+ * the stock item is being sold from other threads.
+ * 
+ * @param  Pointer to stock item containing quantity.
+ * @param  Integer quantity to add to stock.
+ */
+void stockItem_Restock(StockItem *item, const int restockQuantity) {
+    atomic_fetch_add_explicit(&item->quantity, restockQuantity, 
+            memory_order_acq_rel);
+    aggregateSet_applyDelta(item, restockQuantity);
+}
+
+/**
+ * Method to write information about a stock item to a report.
+ * 
+ * @param Pointer to report writer.
+ * @param Pointer to stock item to be written.
+ */
+void stockItem_write(Report *report, const StockItem *item) {
+    report_string(report, "\nType:              ");
+    report_string(report, stockItem_getType(item));
+    report_string(report, "\nID:                ");
+    report_string(report, stockItem_getID(item));
+    report_string(report, "\nQuantity in stock: ");
+    report_int(report, stockItem_getQuantity(item));
+    report_string(report, "\nPrice Per Item:    £");
+    report_money(report, stockItem_getPennies(item));
+    report_string(report, "\nDescription:       ");
+    report_string(report, stockItem_getDesc(item));
+    report_string(report, "\n");
 }
 
 /**
- * Method to print out information about a stock item.
+ * Method to print out information about a stock item to the console.
  * 
  * @param  Pointer to stock item to be printed.
  * @return Print of item information.
  */
 void stockItem_print(const StockItem *item) { 
-    printf("\nType:              %s\n"
-             "ID:                %s\n"
-             "Quantity in stock: %d\n"
-             "Price Per Item:    £%.2f\n"
-             "Description:       %s\n",
-             stockItem_getType(item), 
-             stockItem_getID(item), 
-             stockItem_getQuantity(item), 
-             stockItem_getPrice(item), 
-             stockItem_getDesc(item));
+    Report report;
+    report_init(&report, STDOUT_FILENO);
+    stockItem_write(&report, item);
+    report_flush(&report);
 }
 
 /**
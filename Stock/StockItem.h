@@ -6,6 +6,12 @@
 #ifndef STOCKITEM_H
 #define STOCKITEM_H
 
+#include <stdatomic.h>
+
+#include "Attribute.h"
+#include "Money.h"
+#include "Report.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -15,25 +21,80 @@ extern "C" {
  * for a individual stock item.
  */
 typedef struct StockItemStruct {
-    char *type, *ID, *desc;
-    int quantity, price;
+    char *ID, *desc;
+    // Quantity in stock, atomic so sales can be made from several threads
+    atomic_int quantity;
+    Money price;
+    // Interned component type code
+    unsigned char type;
+    // Description parsed once when stock item is created
+    Attribute attribute;
+    // Index of item within its inventory, or -1 if not in a inventory
+    int index;
+    // Aggregate set this item is counted in and bit mask of its aggregates
+    struct AggregateSetStruct *aggregates;
+    unsigned int aggregateMask;
 }
 StockItem;
 
+/**
+ * Method to fill in a new stock item in memory provided by the caller, 
+ * such as a inventory's arena. The type name is interned, so the string 
+ * passed in is not kept, and the description is parsed into a typed 
+ * attribute.
+ * 
+ * @param  Pointer to memory for stock item.
+ * @param  Char type/name of item.
+ * @param  Char unique ID.
+ * @param  Integer quantity of item in stock.
+ * @param  Price of item in pennies.
+ * @param  Char item description.
+ * @return Pointer to stock item.
+ */
+StockItem* stockItem_init(StockItem *item, const char *type, char *ID, 
+        int quantity, Money price, char *desc);
+
 /**
  * Method to allocate memory for a new stock item containing information 
  * about itself. Or generates error message if memory allocation fails
- * and terminates program.
+ * and terminates program. The type name is interned, so the string passed 
+ * in is not kept, and the description is parsed into a typed attribute.
  * 
  * @param  Char type/name of item.
  * @param  Char unique ID.
  * @param  Integer quantity of item in stock.
- * @param  Integer price of item in pennies.
+ * @param  Price of item in pennies.
  * @param  Char item description.
  * @return Pointer to newly created stock item.
  */
-StockItem* stockItem_new(char *type, char *ID, int quantity, 
-        int price, char *desc);
+StockItem* stockItem_new(const char *type, char *ID, int quantity, 
+        Money price, char *desc);
+
+/**
+ * Method to allocate memory for a copy of a stock item with a different
+ * quantity. The copy shares the ID and description strings of the 
+ * original and is not in any inventory. Or generates error message if 
+ * memory allocation fails and terminates program.
+ * 
+ * @param  Pointer to stock item to be copied.
+ * @param  Integer quantity of copy in stock.
+ * @return Pointer to newly created copy.
+ */
+StockItem* stockItem_copy(const StockItem *item, int quantity);
+
+/**
+ * Method to fill in a copy of a stock item with a different quantity in 
+ * memory provided by the caller, such as a inventory's arena. The copy 
+ * shares the ID and description strings of the original and is not in any
+ * inventory.
+ * 
+ * @param  Pointer to memory for copy.
+ * @param  Pointer to stock item to be copied.
+ * @param  Integer quantity of copy in stock.
+ * @return Pointer to copy.
+ */
+StockItem* stockItem_initCopy(StockItem *copy, const StockItem *item, 
+        int quantity);
 
 /**
  * Get method to get type/name of a stock item.
@@ -41,7 +102,15 @@ StockItem* stockItem_new(char *type, char *ID, int quantity,
  * @param  Pointer to stock item containing type.
  * @return Item type/name char. 
  */
-char *stockItem_getType(const StockItem *item);
+const char *stockItem_getType(const StockItem *item);
+
+/**
+ * Get method to get the interned type code of a stock item.
+ * 
+ * @param  Pointer to stock item containing type.
+ * @return Integer type code, see ComponentType.h. 
+ */
+int stockItem_getTypeCode(const StockItem *item);
 
 /**
  * Get method to get ID of a stock item.
@@ -60,13 +129,22 @@ char *stockItem_getID(const StockItem *item);
 int stockItem_getQuantity(const StockItem *item);
 
 /**
- * Get method to get price of a stock item.
+ * Get method to get price of a stock item in pounds. Kept for 
+ * compatibility, prices should be read with stockItem_getPennies().
  * 
  * @param  Pointer to stock item containing price.
  * @return Item price float in pounds. 
  */
 float stockItem_getPrice(const StockItem *item);
 
+/**
+ * Get method to get price of a stock item in pennies.
+ * 
+ * @param  Pointer to stock item containing price.
+ * @return Item price in pennies. 
+ */
+Money stockItem_getPennies(const StockItem *item);
+
 /**
  * Get method to get description of a stock item.
  * 
@@ -75,10 +153,29 @@ float stockItem_getPrice(const StockItem *item);
  */
 char *stockItem_getDesc(const StockItem *item);
 
+/**
+ * Get method to get the index of a stock item within the inventory it has
+ * been added to. Indexes are given out in the order stock items are added
+ * and are not reused.
+ * 
+ * @param  Pointer to stock item containing index.
+ * @return Integer index, or -1 if stock item is not in a inventory. 
+ */
+int stockItem_getIndex(const StockItem *item);
+
+/**
+ * Get method to get the typed attribute parsed from the description of a
+ * stock item, such as its resistance or capacitance.
+ * 
+ * @param  Pointer to stock item containing attribute.
+ * @return Attribute of stock item, of kind ATTRIBUTE_NONE if it has none. 
+ */
+Attribute stockItem_getAttribute(const StockItem *item);
+
 /**
  * Sale method used to reduce quantity of a stock item by x amount 
  * if stock item has enough quantity within stock for transaction to be 
- * successful.
+ * successful. Any aggregates covering the stock item are updated.
  * 
  * @param  Pointer to stock item containing quantity.
  * @param  Integer sale quantity to sell.
@@ -86,6 +183,40 @@ char *stockItem_getDesc(const StockItem *item);
  */
 int stockItem_Sell(StockItem *item, const int saleQuantity);
 
+/**
+ * Sale method used to make a run of sales of a stock item in order, each 
+ * only if there is enough stock left after the sales before it. Stock is 
+ * reduced once for the whole run, as if the sales had been made one at a 
+ * time by stockItem_Sell(). Any aggregates covering the stock item are 
+ * updated.
+ * 
+ * @param  Pointer to stock item containing quantity.
+ * @param  Array of sale quantities to sell.
+ * @param  Integer number of sales.
+ * @param  Array to set to 1 for each sale made or 0 if not.
+ * @return Total quantity sold.
+ */
+int stockItem_SellEach(StockItem *item, const int *saleQuantities, 
+        int count, unsigned char *sold);
+
+/**
+ * Restock method used to increase quantity of a stock item by x amount. 
+ * Any aggregates covering the stock item are updated. Safe to call while 
+ * the stock item is being sold from other threads.
+ * 
+ * @param  Pointer to stock item containing quantity.
+ * @param  Integer quantity to add to stock.
+ */
+void stockItem_Restock(StockItem *item, const int restockQuantity);
+
+/**
+ * Method to write information about a stock item to a report.
+ * 
+ * @param Pointer to report writer.
+ * @param Pointer to stock item to be written.
+ */
+void stockItem_write(Report *report, const StockItem *item);
+
 /**
  * Method to print out information about a stock item to the console.
  * 
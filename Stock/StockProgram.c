@@ -11,15 +11,17 @@
 #include "Inventory.h"
 #include "Date.h"
 #include "Sales.h"
+#include "ComponentType.h"
+#include "Loader.h"
+#include "Benchmark.h"
+#include "Snapshot.h"
+#include "DailySales.h"
+#include "TopSellers.h"
+#include "InventoryColumns.h"
 
-// Buffer size for each line in file. Although the longest line is 41
-// it is bigger incase line is longer.
-const int LONGEST_LINE_BUFFER = 64;
 // Buffer size for words, again larger than largest word currently in file,
 // for future files.
 const int STRING_BUFFER = 32;
-// Buffer size for date (Date length (10) + null terminator (1))
-const int DATE_BUFFER = 11;
 
 /**
  * Method to test all methods from header files to ensure that everything is 
@@ -42,14 +44,14 @@ void testing() {
     //stockItem_free(item2);
     
     // ------ DATE ------
-    Date *date = date_new(1, 12, 1990);
-    Date *date2 = date_new(1, 3, 1990);
+    Date date = date_new(1, 12, 1990);
+    Date date2 = date_new(1, 3, 1990);
     //printf("%d", date_compare(date, date2));
     //date_print(date);
     //printf("%02d/%02d/%04d\n", date_getDay(date), date_getMonth(date), 
     //        date_getYear(date));
-    //printf("%s\n", date_getDate(date));
-    //date_free(date);
+    //char buffer[DATE_BUFFER];
+    //printf("%s\n", date_format(date, buffer));
     
     // ------ INVENTORY ------
     Inventory* inventory = inventory_new();
@@ -109,226 +111,73 @@ void testing() {
 }
 
 /**
- * Method to read stock items from a file and add each one into a 
- * existing inventory.
+ * Method to calculate and return the date with the highest sales total.
+ * Sales are grouped by day in a single pass, so they do not need to be in 
+ * date order.
  * 
- * @param Pointer to inventory where all stock items will be added to.
- * @param File name of file to be read. 
+ * @param  Sales list to get sales information from.
+ * @return Date with the highest sales total, or DATE_NONE if there are no 
+ *         sales.
  */
-void read_inventory(Inventory* inventory, const char *fileName) {    
-    // Open file in read mode
-    FILE *file = fopen(fileName, "r");
-    
-    // Null check if file has correctly opened
-    if(!file) {
-        fprintf(stderr, "Error: Unable to open '%s' in mode 'r' "
-                "in read_inventory().\n", fileName);
-        exit(EXIT_FAILURE);
-    }
+Date highestSalesDate(const Sales* sales) {
+    DailySales *daily = dailySales_new();
+    DailyTotal highest = { DATE_NONE, 0, 0 };
     
-    // Initialise local line variable
-    char line[LONGEST_LINE_BUFFER];
-
-    // Loop each line in file
-    while (fgets(line, LONGEST_LINE_BUFFER, file)) { 
-        // Initialise stock item variables to global heap
-        char *type = (char*)malloc(sizeof(char) * STRING_BUFFER);
-        char *ID = (char*)malloc(sizeof(char) * STRING_BUFFER);
-        char *quantity = (char*)malloc(sizeof(char) * STRING_BUFFER);
-        char *price = (char*)malloc(sizeof(char) * STRING_BUFFER);
-        char *desc = (char*)malloc(sizeof(char) * STRING_BUFFER);
-
-        // Read line into variables
-        sscanf(line, "%[^, \t\n], %[^, \t\n], %[^, \t\n], %[^, \t\n], "
-                "%s", 
-                type, ID, quantity, price, desc);
-        
-        // As diode doesn't have a description, assign it as N/A
-        if (strcmp(type, "diode") == 0)
-            strncpy(desc, "N/A", sizeof(desc));
-               
-        // Create new stock item
-        StockItem *item = stockItem_new(type, ID, atoi(quantity), 
-                atoi(price), desc);
-
-        // Add stock item to inventory
-        inventory_add(inventory, item);
-    }
+    // Total revenue of each day and find highest day
+    dailySales_addSales(daily, sales);
+    dailySales_top(daily, DAILY_SALES_REVENUE, 1, &highest);
     
-    // Close File
-    fclose(file);
+    dailySales_free(daily);
+    return highest.date;
 }
 
 /**
- * Method to read sales from a file and add each one into a 
- * existing sales list.
+ * Method to find the stock items with the highest revenue in the quarter of
+ * the most recent sale, in a single pass over sales after finding it.
  * 
- * @param Pointer to sales list where all sales will be added to.
- * @param File name of file to be read. 
+ * @param  Pointer to inventory containing stock items sold.
+ * @param  Sales list to get sales information from.
+ * @param  Integer maximum number of stock items to find.
+ * @param  Array of at least count totals where stock items will be stored,
+ *         highest first.
+ * @param  Pointer to where first date of quarter will be stored.
+ * @return Integer number of stock items found.
  */
-void read_sales(Sales* sales, Inventory* inventory, const char *fileName) {    
-    // Open file in read mode
-    FILE *file = fopen(fileName, "r");
-    
-    // Null check if file has correctly opened
-    if(!file) {
-        fprintf(stderr, "Error: Unable to open '%s' in mode 'r' "
-                "in read_sales().\n", fileName);
-        exit(EXIT_FAILURE);
-    }
+int topSellersThisQuarter(const Inventory *inventory, const Sales *sales, 
+        int count, TopSeller *top, Date *quarter) {
+    // Quarter is taken from the newest sale, as sales may be in any order
+    Date latest = DATE_NONE;
+    for (SalesIterator i = sales_first(sales); i != NULL; 
+            i = sales_iteratorNext(i))
+        if (i->date > latest)
+            latest = i->date;
+    if (latest == DATE_NONE)
+        return 0;
     
-    // Initialise local line variable
-    char line[LONGEST_LINE_BUFFER];
-
-    // Loop each line in file
-    while (fgets(line, LONGEST_LINE_BUFFER, file)) {       
-        // Initialise sales variables to global heap
-        char *day = (char*)malloc(sizeof(char) * STRING_BUFFER);
-        char *month = (char*)malloc(sizeof(char) * STRING_BUFFER);
-        char *year = (char*)malloc(sizeof(char) * STRING_BUFFER);
-        char *ID = (char*)malloc(sizeof(char) * STRING_BUFFER);
-        char *quantity = (char*)malloc(sizeof(char) * STRING_BUFFER);
-
-        // Read line into variables
-        sscanf(line, "%[^/]/%[^/]/%[^, \t\n], %[^,\t\n], %[^ \t\n]"
-                "%[^ \t\n]", 
-                day, month, year, ID, quantity);
-        
-        // Allocate date to memory
-        Date *date = date_new(atoi(day), atoi(month), atoi(year));
-        
-        // Add this sale to sales list
-        sales_add(sales, inventory, date, ID, atoi(quantity));
-    }
+    // Quarter ends the day before the next quarter starts
+    int month = (date_getMonth(latest) - 1) / 3 * 3 + 1;
+    int year = date_getYear(latest);
+    TopSellersFilter filter = { date_fromDMY(1, month, year), 
+            (month < 10) ? date_fromDMY(1, month + 3, year) - 1 
+                : date_fromDMY(31, 12, year), COMPONENT_TYPE_NONE };
+    *quarter = filter.from;
     
-    // Close File
-    fclose(file);
+    return topSellers_find(inventory, sales, &filter, TOP_SELLERS_REVENUE, 
+            count, top);
 }
 
 /**
- * Method to calculate and return the date with the highest sales total.
+ * Method to format a total resistance in the form of BS 1852 letter coding.
  * 
- * @param  Sales list to get sales information from.
- * @return Date string with the highest sales total.
+ * @param  Long total resistance in milliohms.
+ * @return Total resistance in the form of BS 1852 letter coding.
  */
-char *highestSalesDate(Sales* sales) {
-    // Date string of current day and date with highest sales
-    char *currentDate = (char*)malloc(sizeof(char) * DATE_BUFFER);
-    char *dateHighest = (char*)malloc(sizeof(char) * DATE_BUFFER);
-            
-    // Current used to store sales within the current date
-    float current = 0;
-    // Highest date sales value based on current
-    float highest = 0;
-
-    // Loop all sales nodes
-    for (SalesNode* node = sales->first; node != NULL; 
-            node = node->next) {
-        // If date changes
-        if (strcmp(currentDate, date_getDate(node->date)) != 0) {
-            // Set current date as the return date if it had the highest sales
-            if (current > highest) {
-                highest = current;
-                strncpy(dateHighest, currentDate, DATE_BUFFER);
-            }
-            
-            // Reset values for the next cycle
-            strncpy(currentDate, date_getDate(node->date), DATE_BUFFER);
-            current = 0;
-        }
-        
-        // Increase the current total for this date
-        current += sales_getCost(node);
-    }
-    
-    return dateHighest;
-}
-
-int NPNTransistorsCount(Inventory* inventory) {
-    int count = 0;
-    // If inventory is not empty
-    if (inventory->first != NULL) {
-        // Loop all nodes within inventory
-        for(InventoryNode* node = inventory->first; node != NULL;
-                node = node->next) {
-            // Get item from node
-            StockItem *item = node->item;
-                        
-            // If current node is a transistor and has NPN as description add
-            // its quantity to total count
-            if ((strcmp("transistor", stockItem_getType(item)) == 0) 
-                    && (strcmp("NPN", stockItem_getDesc(item)) == 0)) 
-                count += stockItem_getQuantity(item);
-        }
-    // Else display error message to console
-    } else
-        fprintf(stderr, "Error: Inventory empty in "
-                "NPNTransistorsCount().\n");
-    
-    return count;
-}
-
-char *resistanceOfRegisters(Inventory* inventory) {    
+char *resistanceToString(long long totalMilliohms) {
     // Used to output the resistance in the form of BS 1852 letter coding
     char *resistance = (char*)malloc(sizeof(char) * STRING_BUFFER);
     
-    // Total resistance of registers
-    double totalResistance = 0;
-    
-    // If inventory is not empty
-    if (inventory->first != NULL) {
-        // Loop all nodes within inventory
-        for(InventoryNode* node = inventory->first; node != NULL;
-                node = node->next) {
-            // Get item from node
-            StockItem *item = node->item;
-            
-            // If this stock item is a resistor and has stock
-            if ((strcmp("resistor", stockItem_getType(item)) == 0
-                    && (stockItem_getQuantity(item) > 0))) {
-                
-                // Get pointer to description
-                char *desc = stockItem_getDesc(item);
-                // Used as boolean state
-                int side = 1;
-                // Type of resistance and strength
-                char type;
-                // Long instead of integer to support larger resistances
-                long integer = 0;
-                long decimal = 0;
-                
-                for (int i = 0; i < strlen(desc); i++) {
-                    // Get type of resistance
-                    if(isalpha(desc[i])) {
-                        type = desc[i];
-                        // Change current side
-                        side = 0;
-                    } 
-                    else if (side) 
-                        // Get left side integer of type symbol
-                        integer = integer * 10 + (desc[i] - 48);
-                    else
-                        // Get right side integer of ohm symbol
-                        decimal = decimal * 10 + (desc[i] - 48);
-                }
-   
-                // Add integer part of resistance to decimal part
-                integer = (integer + (decimal / 10));
-
-                // Determine type and multiple value by its amount
-                if(type == 'K')
-                    integer = integer * 1000;
-                else if (type == 'M')
-                    integer = integer * 1000000;
-                
-                // Increase total by this resistors resistance * quantity
-                totalResistance += (integer * stockItem_getQuantity(item));
-            }
-        }
-    // Else display error message to console
-    } else
-        fprintf(stderr, "Error: Inventory empty in "
-                "resistanceOfRegisters().\n");
+    // Total resistance in ohms
+    double totalResistance = totalMilliohms / 1000.0;
     
     // Determine type of resistance and divide by given type
     char type;
@@ -353,25 +202,55 @@ char *resistanceOfRegisters(Inventory* inventory) {
 }
 
 /**
- * Main used to run program outputs.
+ * Main used to run program outputs. Running with the argument "benchmark",
+ * optionally followed by a benchmark name, runs benchmarks instead.
  * 
  * @return Exit success integer. 
  */
 int main(int argc, char** argv) {
     printf(" --- Stock Program --- \n");
+    
+    // Run benchmarks if requested
+    if ((argc > 1) && (strcmp(argv[1], "benchmark") == 0)) {
+        if (!benchmark_run((argc > 2) ? argv[2] : NULL)) {
+            fprintf(stderr, "Error: Unknown benchmark '%s'.\n", argv[2]);
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
       
     // Run testing data performed on program
     //testing();
     
-    // Initialise new inventory list
+    // Initialise new inventory and sales lists
     Inventory* inventory = inventory_new();
-    // Read inventory file into the inventory
-    read_inventory(inventory, "inventory.txt");
-
-    // Initialise new sales list
     Sales* sales = sales_new();
-    // Read sales file into the sales list
-    read_sales(sales, inventory, "sales.txt");
+    
+    // Load snapshot of previous run, or if it is missing or out of date 
+    // read inventory and sales files and write a new snapshot
+    Snapshot snapshot;
+    if (!snapshot_load(&snapshot, "stock.snapshot", inventory, sales, 
+            "inventory.txt", "sales.txt")) {
+        loader_readInventory(inventory, "inventory.txt");
+        loader_readSalesParallel(sales, inventory, "sales.txt", 0, NULL);
+        snapshot_write("stock.snapshot", inventory, sales, "inventory.txt", 
+                "sales.txt");
+    }
+
+    // Register aggregates for queries 3 and 4, kept up to date as further
+    // sales are made
+    AggregateFilter NPNTransistors = { componentType_intern("transistor"), 
+            ATTRIBUTE_POLARITY, ATTRIBUTE_POLARITY_NPN, 
+            ATTRIBUTE_POLARITY_NPN };
+    AggregateFilter resistors = { componentType_intern("resistor"), 
+            ATTRIBUTE_NONE, 0, 0 };
+    int NPNTransistorsCount = inventory_registerAggregate(inventory, 
+            AGGREGATE_QUANTITY, aggregate_filter, &NPNTransistors);
+    int resistanceOfResistors = inventory_registerAggregate(inventory, 
+            AGGREGATE_ATTRIBUTE, aggregate_filter, &resistors);
+    
+    // Build columns for range queries, synced before each is run
+    InventoryColumns *columns = inventoryColumns_new(inventory);
     
     // ------------ Query 1: ------------
     printf("\nQUERY 1: Inventory (Sorted on increasing price):");
@@ -387,22 +266,69 @@ int main(int argc, char** argv) {
     printf("\nQUERY 2: Date with the greatest sales volume (Based on the day "
             "with the highest sales total):\n");
     // Print date with highest sales to output
-    printf("%s yielded highest sales volume.\n", highestSalesDate(sales));
+    Date highest = highestSalesDate(sales);
+    char date[DATE_BUFFER];
+    if (highest != DATE_NONE)
+        printf("%s yielded highest sales volume.\n", 
+                date_format(highest, date));
+    else
+        printf("No sale has been made.\n");
     
     // ------------ Query 3: ------------
     printf("\nQUERY 3: Total NPN transistors in stock after processing sales:"
             "\n");
     // Print number of transistors in stock
-    printf("%d in stock.\n", NPNTransistorsCount(inventory));
+    printf("%lld in stock.\n", 
+            inventory_getAggregate(inventory, NPNTransistorsCount));
 
     // ------------ Query 4: ------------
     printf("\nQUERY 4: Total resistance of all remaining registers in stock:"
             "\n");
-    printf("%s\u2126 total resistance.\n", resistanceOfRegisters(inventory));
+    printf("%s\u2126 total resistance.\n", resistanceToString(
+            inventory_getAggregate(inventory, resistanceOfResistors)));
+    
+    // ------------ Query 5: ------------
+    printf("\nQUERY 5: Top 20 stock items by revenue this quarter (Based on "
+            "the quarter of the most recent sale):\n");
+    TopSeller top[20];
+    Date quarter = DATE_NONE;
+    int found = topSellersThisQuarter(inventory, sales, 20, top, &quarter);
+    if (found > 0)
+        printf("Quarter starting %s:\n", date_format(quarter, date));
+    else
+        printf("No sale has been made.\n");
+    for (int i = 0; i < found; i++) 
+        printf("%2d. %-12s £%lld.%02lld\n", i + 1, 
+                stockItem_getID(top[i].item), 
+                (long long)(top[i].revenue / 100), 
+                (long long)(top[i].revenue % 100));
+    
+    // ------------ Query 6: ------------
+    printf("\nQUERY 6: Capacitors between 10nF and 1uF in stock:\n");
+    inventoryColumns_sync(columns);
+    int *rows = (int*)malloc(sizeof(int) 
+            * (inventoryColumns_count(columns) + 1));
+    // Null check memory allocation
+    if (!rows) {
+        fprintf(stderr, "Error: Unable to allocate memory in main().\n");
+        exit(EXIT_FAILURE);
+    }
+    // Capacitance is held in picofarads
+    int inRange = inventoryColumns_findRange(columns, ATTRIBUTE_CAPACITANCE, 
+            10000, 1000000, 1, rows);
+    for (int i = 0; i < inRange; i++)
+        printf("%-12s %8s %6d in stock\n", 
+                inventoryColumns_getID(columns, rows[i]), 
+                inventoryColumns_getDesc(columns, rows[i]), 
+                inventoryColumns_quantities(columns)[rows[i]]);
+    printf("%d capacitors in range.\n", inRange);
+    free(rows);
     
     // Free all from memory
+    inventoryColumns_free(columns);
     inventory_free(inventory);
     sales_free(sales);
+    snapshot_close(&snapshot);
     
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,92 @@
+/* 
+ * File:   TopSellers.c
+ * Author: Paulo Jorge
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "TopSellers.h"
+#include "StockItem.h"
+#include "ComponentType.h"
+#include "Ranking.h"
+
+/**
+ * Method to find the stock items with the highest sales totals of a
+ * measure. Sales are totalled per stock item by item index in a single
+ * pass, then the best are selected with a heap holding only the number of
+ * stock items asked for. Stock items without counted sales are never
+ * returned and stock items with equal totals are ranked in the order they
+ * were added to the inventory. Or generates error message if memory
+ * allocation fails and terminates program.
+ * 
+ * @param  Pointer to inventory containing stock items sold.
+ * @param  Pointer to sales list to be totalled.
+ * @param  Pointer to filter sales must match, or null to count all sales.
+ * @param  Measure stock items are ranked on.
+ * @param  Integer maximum number of stock items to find.
+ * @param  Array of at least count totals where stock items will be
+ *         stored, highest first.
+ * @return Integer number of stock items found.
+ */
+int topSellers_find(const Inventory *inventory, const Sales *sales,
+        const TopSellersFilter *filter, TopSellersMeasure measure,
+        int count, TopSeller *top) {
+    int items = inventory_itemCount(inventory);
+    if ((count <= 0) || (items == 0))
+        return 0;
+
+    // Open ends of range match every date
+    Date from = (filter && (filter->from != DATE_NONE))
+            ? filter->from : INT32_MIN;
+    Date to = (filter && (filter->to != DATE_NONE)) ? filter->to : INT32_MAX;
+    int type = filter ? filter->type : COMPONENT_TYPE_NONE;
+
+    // Total sales of each stock item by item index
+    Money *revenue = (Money*)calloc(items, sizeof(Money));
+    long long *units = (long long*)calloc(items, sizeof(long long));
+    // Null check memory allocation
+    if (!revenue || !units) {
+        fprintf(stderr, "Error: Unable to allocate memory in "
+                "topSellers_find().\n");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int i = 0; i < sales->count; i++) {
+        const SalesRecord *record = &sales->records[i];
+        int index = stockItem_getIndex(record->item);
+
+        // Skip sales outside filter or of stock items since removed
+        if ((record->date < from) || (record->date > to) || (index < 0)
+                || ((type != COMPONENT_TYPE_NONE)
+                    && (stockItem_getTypeCode(record->item) != type)))
+            continue;
+
+        revenue[index] += sales_getTotal(record);
+        units[index]   += record->quantity;
+    }
+
+    // Rank stock items by item index, which orders stock items with equal
+    // totals in the order they were added
+    RankingEntry *heap = ranking_new((count < items) ? count : items);
+    int found = 0;
+    for (int i = 0; i < items; i++)
+        if (units[i] != 0)
+            found = ranking_offer(heap, found, count,
+                    (measure == TOP_SELLERS_REVENUE) ? revenue[i] : units[i],
+                    i);
+    ranking_sort(heap, found);
+
+    for (int i = 0; i < found; i++) {
+        int index = heap[i].index;
+        top[i] = (TopSeller){ inventory_getItem(inventory, index),
+                revenue[index], units[index] };
+    }
+
+    free(heap);
+    free(revenue);
+    free(units);
+
+    return found;
+}
@@ -0,0 +1,76 @@
+/* 
+ * File:   TopSellers.h
+ * Author: Paulo Jorge
+ */
+
+#ifndef TOPSELLERS_H
+#define TOPSELLERS_H
+
+#include "Date.h"
+#include "Inventory.h"
+#include "Sales.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Measures stock items can be ranked on.
+ */
+typedef enum TopSellersMeasureEnum {
+    // Total revenue in pennies
+    TOP_SELLERS_REVENUE,
+    // Total number of units sold
+    TOP_SELLERS_UNITS
+}
+TopSellersMeasure;
+
+/**
+ * Structure holding the totals of all sales of one stock item.
+ */
+typedef struct TopSellerStruct {
+    StockItem *item;
+    Money revenue;
+    long long units;
+}
+TopSeller;
+
+/**
+ * Filter restricting which sales are counted by topSellers_find().
+ */
+typedef struct TopSellersFilterStruct {
+    // Inclusive date range, DATE_NONE leaves that end of range open
+    Date from, to;
+    // Type code to match, or COMPONENT_TYPE_NONE to match any type
+    int type;
+}
+TopSellersFilter;
+
+/**
+ * Method to find the stock items with the highest sales totals of a
+ * measure. Sales are totalled per stock item by item index in a single
+ * pass, then the best are selected with a heap holding only the number of
+ * stock items asked for. Stock items without counted sales are never
+ * returned and stock items with equal totals are ranked in the order they
+ * were added to the inventory. Or generates error message if memory
+ * allocation fails and terminates program.
+ * 
+ * @param  Pointer to inventory containing stock items sold.
+ * @param  Pointer to sales list to be totalled.
+ * @param  Pointer to filter sales must match, or null to count all sales.
+ * @param  Measure stock items are ranked on.
+ * @param  Integer maximum number of stock items to find.
+ * @param  Array of at least count totals where stock items will be
+ *         stored, highest first.
+ * @return Integer number of stock items found.
+ */
+int topSellers_find(const Inventory *inventory, const Sales *sales,
+        const TopSellersFilter *filter, TopSellersMeasure measure,
+        int count, TopSeller *top);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TOPSELLERS_H */
+
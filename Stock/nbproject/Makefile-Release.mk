@@ -35,11 +35,30 @@ OBJECTDIR=${CND_BUILDDIR}/${CND_CONF}/${CND_PLATFORM}
 
 # Object Files
 OBJECTFILES= \
+	${OBJECTDIR}/Aggregate.o \
+	${OBJECTDIR}/Arena.o \
+	${OBJECTDIR}/Attribute.o \
+	${OBJECTDIR}/Benchmark.o \
+	${OBJECTDIR}/ComponentType.o \
+	${OBJECTDIR}/DailySales.o \
 	${OBJECTDIR}/Date.o \
 	${OBJECTDIR}/Inventory.o \
+	${OBJECTDIR}/InventoryColumns.o \
+	${OBJECTDIR}/InventoryView.o \
+	${OBJECTDIR}/Loader.o \
+	${OBJECTDIR}/Money.o \
+	${OBJECTDIR}/Pool.o \
+	${OBJECTDIR}/Ranking.o \
+	${OBJECTDIR}/Report.o \
+	${OBJECTDIR}/SaleQueue.o \
 	${OBJECTDIR}/Sales.o \
+	${OBJECTDIR}/SalesIndex.o \
+	${OBJECTDIR}/SalesRollup.o \
+	${OBJECTDIR}/ShardedInventory.o \
+	${OBJECTDIR}/Snapshot.o \
 	${OBJECTDIR}/StockItem.o \
-	${OBJECTDIR}/StockProgram.o
+	${OBJECTDIR}/StockProgram.o \
+	${OBJECTDIR}/TopSellers.o
 
 
 # C Compiler Flags
@@ -56,7 +75,7 @@ FFLAGS=
 ASFLAGS=
 
 # Link Libraries and Options
-LDLIBSOPTIONS=
+LDLIBSOPTIONS=-lpthread
 
 # Build Targets
 .build-conf: ${BUILD_SUBPROJECTS}
@@ -66,6 +85,36 @@ ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}/stock.exe: ${OBJECTFILES}
 	${MKDIR} -p ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}
 	${LINK.c} -o ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}/stock ${OBJECTFILES} ${LDLIBSOPTIONS}
 
+${OBJECTDIR}/Aggregate.o: Aggregate.c
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.c) -O2 -std=c11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/Aggregate.o Aggregate.c
+
+${OBJECTDIR}/Arena.o: Arena.c
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.c) -O2 -std=c11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/Arena.o Arena.c
+
+${OBJECTDIR}/Attribute.o: Attribute.c
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.c) -O2 -std=c11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/Attribute.o Attribute.c
+
+${OBJECTDIR}/Benchmark.o: Benchmark.c
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.c) -O2 -std=c11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/Benchmark.o Benchmark.c
+
+${OBJECTDIR}/ComponentType.o: ComponentType.c
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.c) -O2 -std=c11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/ComponentType.o ComponentType.c
+
+${OBJECTDIR}/DailySales.o: DailySales.c
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.c) -O2 -std=c11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/DailySales.o DailySales.c
+
 ${OBJECTDIR}/Date.o: Date.c
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"
@@ -76,11 +125,71 @@ ${OBJECTDIR}/Inventory.o: Inventory.c
 	${RM} "$@.d"
 	$(COMPILE.c) -O2 -std=c11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/Inventory.o Inventory.c
 
+${OBJECTDIR}/InventoryColumns.o: InventoryColumns.c
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.c) -O2 -std=c11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/InventoryColumns.o InventoryColumns.c
+
+${OBJECTDIR}/InventoryView.o: InventoryView.c
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.c) -O2 -std=c11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/InventoryView.o InventoryView.c
+
+${OBJECTDIR}/Loader.o: Loader.c
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.c) -O2 -std=c11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/Loader.o Loader.c
+
+${OBJECTDIR}/Money.o: Money.c
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.c) -O2 -std=c11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/Money.o Money.c
+
+${OBJECTDIR}/Pool.o: Pool.c
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.c) -O2 -std=c11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/Pool.o Pool.c
+
+${OBJECTDIR}/Ranking.o: Ranking.c
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.c) -O2 -std=c11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/Ranking.o Ranking.c
+
+${OBJECTDIR}/Report.o: Report.c
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.c) -O2 -std=c11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/Report.o Report.c
+
+${OBJECTDIR}/SaleQueue.o: SaleQueue.c
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.c) -O2 -std=c11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/SaleQueue.o SaleQueue.c
+
 ${OBJECTDIR}/Sales.o: Sales.c
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"
 	$(COMPILE.c) -O2 -std=c11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/Sales.o Sales.c
 
+${OBJECTDIR}/SalesIndex.o: SalesIndex.c
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.c) -O2 -std=c11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/SalesIndex.o SalesIndex.c
+
+${OBJECTDIR}/SalesRollup.o: SalesRollup.c
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.c) -O2 -std=c11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/SalesRollup.o SalesRollup.c
+
+${OBJECTDIR}/ShardedInventory.o: ShardedInventory.c
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.c) -O2 -std=c11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/ShardedInventory.o ShardedInventory.c
+
+${OBJECTDIR}/Snapshot.o: Snapshot.c
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.c) -O2 -std=c11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/Snapshot.o Snapshot.c
+
 ${OBJECTDIR}/StockItem.o: StockItem.c
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"
@@ -91,6 +200,11 @@ ${OBJECTDIR}/StockProgram.o: StockProgram.c
 	${RM} "$@.d"
 	$(COMPILE.c) -O2 -std=c11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/StockProgram.o StockProgram.c
 
+${OBJECTDIR}/TopSellers.o: TopSellers.c
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.c) -O2 -std=c11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/TopSellers.o TopSellers.c
+
 # Subprojects
 .build-subprojects:
 